@@ -0,0 +1,227 @@
+#include "../lib/include/primality.h"
+#include "../lib/include/primes.h"
+#include "../lib/include/primes_index.h"
+#include "../lib/include/primes_writer.h"
+#include "../lib/include/sieve_kernels.h"
+#include "../lib/include/wheel_sieve.h"
+#include "benchmark/benchmark.h"
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+static void cache_construction(benchmark::State &state) {
+  for (auto _ : state) {
+    PrimesCache cache;
+    benchmark::DoNotOptimize(cache.size());
+  }
+}
+BENCHMARK(cache_construction);
+
+static void add_primes(benchmark::State &state) {
+  PrimesCache cache;
+  cache.fill(static_cast<uint32_t>(state.range(0)));
+  for (auto _ : state) {
+    cache.add_primes();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          SECTOR_SIZE);
+}
+BENCHMARK(add_primes)
+    ->Arg(0)
+    ->Arg(INT64_C(1) << 26)
+    ->Arg(INT64_C(1) << 30)
+    ->Unit(benchmark::kMillisecond);
+
+static void subscript(benchmark::State &state) {
+  PrimesCache cache;
+  cache.fill(static_cast<uint32_t>(state.range(0)));
+  uint32_t size = cache.size();
+  uint32_t pos = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache[pos]);
+    pos = (pos * UINT32_C(1664525) + UINT32_C(1013904223)) % size;
+  }
+}
+BENCHMARK(subscript)->Arg(INT64_C(1) << 20)->Arg(INT64_C(1) << 28);
+
+static void call(benchmark::State &state) {
+  PrimesCache cache;
+  uint32_t pos = static_cast<uint32_t>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache(pos));
+  }
+}
+BENCHMARK(call)
+    ->Arg(INT64_C(1) << 10)
+    ->Arg(INT64_C(1) << 17)
+    ->Arg(INT64_C(1) << 24)
+    ->Unit(benchmark::kMicrosecond);
+
+static void primes_max(benchmark::State &state) {
+  for (auto _ : state) {
+    PrimesCache cache;
+    cache.fill(static_cast<uint32_t>(state.range(0)));
+    benchmark::DoNotOptimize(cache.size());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          state.range(0));
+}
+BENCHMARK(primes_max)
+    ->Arg(INT64_C(1) << 20)
+    ->Arg(INT64_C(1) << 24)
+    ->Arg(INT64_C(1) << 28)
+    ->Arg(UINT32_MAX)
+    ->Unit(benchmark::kMillisecond);
+
+static void iterator_scan(benchmark::State &state) {
+  Primes primes(static_cast<uint32_t>(state.range(0)));
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (uint32_t prime : primes) {
+      sum += prime;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          primes.size());
+}
+BENCHMARK(iterator_scan)
+    ->Arg(INT64_C(1) << 20)
+    ->Arg(INT64_C(1) << 24)
+    ->Unit(benchmark::kMillisecond);
+
+static void fetch_scan(benchmark::State &state) {
+  Primes primes(static_cast<uint32_t>(state.range(0)));
+  std::vector<uint32_t> buffer(4096);
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (uint32_t pos = 0, count;
+         (count = static_cast<uint32_t>(
+              primes.fetch(pos, buffer.size(), buffer.data())));
+         pos += count) {
+      for (uint32_t i = 0; i < count; ++i) {
+        sum += buffer[i];
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          primes.size());
+}
+BENCHMARK(fetch_scan)
+    ->Arg(INT64_C(1) << 20)
+    ->Arg(INT64_C(1) << 24)
+    ->Unit(benchmark::kMillisecond);
+
+static void output_formatting(benchmark::State &state) {
+  int fd = open("/dev/null", O_WRONLY);
+  Primes primes(static_cast<uint32_t>(state.range(0)));
+  std::vector<uint32_t> values(primes.begin(), primes.end());
+  for (auto _ : state) {
+    PrimesWriter writer(fd, ' ');
+    for (uint32_t value : values) {
+      writer.write(value);
+    }
+  }
+  close(fd);
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(values.size()));
+}
+BENCHMARK(output_formatting)
+    ->Arg(INT64_C(1) << 24)
+    ->Unit(benchmark::kMillisecond);
+
+static void index_subscript(benchmark::State &state) {
+  PrimesIndex index(static_cast<uint32_t>(state.range(0)));
+  uint32_t pos = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(index[pos]);
+    pos = (pos * UINT32_C(1664525) + UINT32_C(1013904223)) % index.size();
+  }
+  state.counters["memory"] = static_cast<double>(index.memory());
+}
+BENCHMARK(index_subscript)
+    ->Arg(INT64_C(1) << 28)
+    ->Arg(UINT32_MAX)
+    ->Unit(benchmark::kMicrosecond);
+
+static std::vector<uint8_t> sieve_bitmap() {
+  std::vector<uint8_t> result;
+  for_each_segment(UINT64_C(1) << 32, (UINT64_C(1) << 32) + (1 << 24),
+                   [&result](WheelSieve const &segment) {
+                     result.insert(result.end(), segment.bitmap().begin(),
+                                   segment.bitmap().end());
+                   });
+  return result;
+}
+
+static void kernel_count(benchmark::State &state) {
+  SieveKernels kernel =
+      supported_sieve_kernels()[static_cast<size_t>(state.range(0))];
+  std::vector<uint8_t> bitmap = sieve_bitmap();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(kernel.count(bitmap.data(), bitmap.size()));
+  }
+  state.SetLabel(kernel.isa);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(bitmap.size()));
+}
+BENCHMARK(kernel_count)->DenseRange(
+    0, static_cast<int>(supported_sieve_kernels().size()) - 1);
+
+static void kernel_decode(benchmark::State &state) {
+  SieveKernels kernel =
+      supported_sieve_kernels()[static_cast<size_t>(state.range(0))];
+  std::vector<uint8_t> bitmap = sieve_bitmap();
+  std::vector<uint64_t> values(8 * bitmap.size());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(kernel.decode(bitmap.data(), bitmap.size(),
+                                           UINT64_C(1) << 32, values.data()));
+  }
+  state.SetLabel(kernel.isa);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(bitmap.size()));
+}
+BENCHMARK(kernel_decode)->DenseRange(
+    0, static_cast<int>(supported_sieve_kernels().size()) - 1);
+
+static std::vector<uint64_t> primality_inputs(int64_t bits) {
+  std::vector<uint64_t> result(1 << 14);
+  uint64_t value = UINT64_C(88172645463325252);
+  for (uint64_t &n : result) {
+    value ^= value << 13;
+    value ^= value >> 7;
+    value ^= value << 17;
+    n = (value >> (64 - bits)) | 1;
+  }
+  return result;
+}
+
+static void primality_scalar(benchmark::State &state) {
+  std::vector<uint64_t> values = primality_inputs(state.range(0));
+  for (auto _ : state) {
+    size_t found = 0;
+    for (uint64_t n : values) {
+      found += is_prime(n);
+    }
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(values.size()));
+}
+BENCHMARK(primality_scalar)->Arg(32)->Arg(64);
+
+static void primality_batch(benchmark::State &state) {
+  std::vector<uint64_t> values = primality_inputs(state.range(0));
+  std::vector<bool> result;
+  for (auto _ : state) {
+    is_prime(values.data(), values.data() + values.size(), result);
+    benchmark::DoNotOptimize(result.size());
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(values.size()));
+}
+BENCHMARK(primality_batch)->Arg(32)->Arg(64);
+
+BENCHMARK_MAIN();
@@ -1,6 +1,22 @@
+#include "../lib/include/primality.h"
+#include "../lib/include/prime_count.h"
+#include "../lib/include/prime_filters.h"
+#include "../lib/include/prime_reducers.h"
 #include "../lib/include/primes.h"
+#include "../lib/include/primes_bitmap.h"
+#include "../lib/include/primes_index.h"
+#include "../lib/include/primes_range.h"
+#include "../lib/include/primes_stream.h"
+#include "../lib/include/primes_writer.h"
+#include "../lib/include/sieve_kernels.h"
+#include "../lib/include/small_primes.h"
+#include "../lib/include/wheel_sieve.h"
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
 
 #define FULL_TEST_MODE_OFF
 
@@ -48,6 +64,31 @@ TEST(PrimesCache_by_pos, precalc) {
   }
 }
 
+TEST(PrimesCache_by_pos, parallel_fill) {
+  PrimesCache sequential;
+  PrimesCache parallel;
+  while (sequential.last_checked() < MAX_NUMBER) {
+    sequential.add_primes();
+  }
+  parallel.fill(MAX_NUMBER, 4);
+  EXPECT_EQ(parallel.last_checked(), sequential.last_checked());
+  ASSERT_EQ(parallel.size(), sequential.size());
+  EXPECT_TRUE(std::equal(parallel.begin(), parallel.end(), sequential.begin()));
+}
+
+TEST(PrimesCache_by_pos, parallel_fill_resume) {
+  CompactPrimesCache obj;
+  obj.fill(3000000, 4);
+  obj.add_primes();
+  obj.fill(20000000, 4);
+  size_t count = static_cast<size_t>(
+      std::upper_bound(real_primes.begin(), real_primes.end(),
+                       obj.last_checked()) -
+      real_primes.begin());
+  ASSERT_EQ(obj.size(), count);
+  EXPECT_TRUE(std::equal(obj.begin(), obj.end(), real_primes.begin()));
+}
+
 TEST(PrimesCache_by_pos, intime) {
   PrimesCache obj;
   for (uint32_t i = 0;
@@ -56,6 +97,19 @@ TEST(PrimesCache_by_pos, intime) {
   }
 }
 
+TEST(PrimesCache_by_pos, intime_deep) {
+  PrimesCache obj;
+  for (uint32_t i = 5000; i < static_cast<uint32_t>(real_primes.size());
+       i += 99991) {
+    EXPECT_EQ(obj(i), real_primes[i]);
+  }
+  EXPECT_EQ(obj(static_cast<uint32_t>(real_primes.size() - 1)),
+            real_primes.back());
+  EXPECT_EQ(obj(203280220), 4294967291u);
+  EXPECT_EQ(obj(203280221), 0u);
+  EXPECT_EQ(obj.size(), 309u);
+}
+
 TEST(Primes_WITHOUT_STATIC, by_pos) {
   Primes obj;
   for (uint32_t i = 0;
@@ -144,6 +198,477 @@ TEST(Primes_by_iterator, random_access) {
   }
 }
 
+TEST(CompactPrimes, by_pos) {
+  CompactPrimes obj(MAX_NUMBER);
+  ASSERT_EQ(obj.size(), real_primes.size());
+  for (uint32_t i = 0; i < static_cast<uint32_t>(real_primes.size()); ++i) {
+    EXPECT_EQ(obj[i], real_primes[i]);
+  }
+}
+
+TEST(CompactPrimes, by_iterator) {
+  GapStorage storage;
+  for (uint32_t prime : real_primes) {
+    storage.push_back(prime);
+  }
+  ASSERT_EQ(storage.size(), real_primes.size());
+  EXPECT_TRUE(std::equal(storage.begin(), storage.end(), real_primes.begin()));
+  auto it = storage.end();
+  for (auto real = real_primes.rbegin(); real != real_primes.rend(); ++real) {
+    EXPECT_EQ(*--it, *real);
+  }
+  EXPECT_EQ(std::upper_bound(storage.begin(), storage.end(), 1000000) -
+                storage.begin(),
+            std::upper_bound(real_primes.begin(), real_primes.end(), 1000000) -
+                real_primes.begin());
+}
+
+TEST(Primes64, by_pos) {
+  Primes64 obj(MAX_NUMBER);
+  ASSERT_EQ(obj.size(), real_primes.size());
+  for (uint64_t i = 0; i < real_primes.size(); ++i) {
+    EXPECT_EQ(obj[i], real_primes[i]);
+  }
+  PrimesCache64 cache;
+  for (uint64_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(cache(i), real_primes[i]);
+  }
+  EXPECT_EQ(cache(299999999), UINT64_C(6461335109));
+}
+
+TEST(Primes64, gap_escape) {
+  std::vector<uint64_t> values{(UINT64_C(1) << 40) + 1};
+  for (uint64_t i = 0; i < 200; ++i) {
+    values.push_back(values.back() + 2 + (i % 3) * 700);
+  }
+  BasicGapStorage<uint64_t> storage;
+  for (uint64_t value : values) {
+    storage.push_back(value);
+  }
+  ASSERT_EQ(storage.size(), values.size());
+  EXPECT_TRUE(std::equal(storage.begin(), storage.end(), values.begin()));
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(storage[i], values[i]);
+  }
+}
+
+TEST(MappedPrimes, file) {
+  std::string path = testing::TempDir() + "primes_cache.bin";
+  std::remove(path.c_str());
+  {
+    PrimesCache cache;
+    cache.fill(MAX_NUMBER / 2, 1);
+    ASSERT_TRUE(cache.save(path.c_str()));
+  }
+  MappedPrimesCache mapped;
+  ASSERT_TRUE(mapped.load(path.c_str()));
+  EXPECT_EQ(mapped.size(),
+            std::upper_bound(real_primes.begin(), real_primes.end(),
+                             mapped.last_checked()) -
+                real_primes.begin());
+  mapped.fill(MAX_NUMBER, 1);
+  ASSERT_TRUE(mapped.save(path.c_str()));
+  CompactPrimesCache compact;
+  ASSERT_TRUE(compact.load(path.c_str()));
+  EXPECT_EQ(compact.last_checked(), mapped.last_checked());
+  ASSERT_EQ(compact.size(), mapped.size());
+  EXPECT_TRUE(std::equal(mapped.begin(), mapped.end(), compact.begin()));
+  for (uint32_t i = 0; i < real_primes.size(); ++i) {
+    ASSERT_EQ(mapped[i], real_primes[i]);
+  }
+  PrimesCache64 wide;
+  EXPECT_FALSE(wide.load(path.c_str()));
+  EXPECT_EQ(wide.size(), PrimesCache64().size());
+  std::remove(path.c_str());
+}
+
+TEST(ConcurrentPrimes, threads) {
+  const uint32_t threads = 4;
+  std::vector<uint32_t> mismatches(threads, 0);
+  std::vector<std::thread> pool;
+  for (uint32_t t = 0; t < threads; ++t) {
+    pool.emplace_back([t, &mismatches]() {
+      ConcurrentPrimes obj;
+      for (uint32_t i = t; i < real_primes.size(); i += threads) {
+        mismatches[t] += obj[i] != real_primes[i];
+      }
+      ConcurrentPrimes bounded(MAX_NUMBER / (t + 1));
+      auto it = std::upper_bound(real_primes.begin(), real_primes.end(),
+                                 MAX_NUMBER / (t + 1));
+      mismatches[t] += bounded.size() != it - real_primes.begin();
+    });
+  }
+  for (std::thread &thread : pool) {
+    thread.join();
+  }
+  EXPECT_EQ(mismatches, std::vector<uint32_t>(threads, 0));
+  ChunkedStorage storage;
+  for (uint32_t i = 0; i < 3 * CHUNK_SIZE; ++i) {
+    storage.push_back(i);
+  }
+  EXPECT_EQ(storage.size(), 3 * CHUNK_SIZE);
+  EXPECT_EQ(storage.back(), 3 * CHUNK_SIZE - 1);
+  EXPECT_EQ(storage[CHUNK_SIZE], CHUNK_SIZE);
+  EXPECT_EQ(storage.end() - storage.begin(), 3 * CHUNK_SIZE);
+}
+
+TEST(ChunkedStorage, reserve) {
+  BasicChunkedStorage<uint64_t> storage;
+  for (uint64_t i = 0; i < CHUNK_SIZE / 2; ++i) {
+    storage.push_back(i);
+  }
+  storage.reserve(CHUNK_ARENA * CHUNK_SIZE * 3);
+  EXPECT_EQ(storage.capacity(), CHUNK_ARENA * CHUNK_SIZE * 3);
+  EXPECT_EQ(storage.memory(), storage.capacity() * sizeof(uint64_t) +
+                                  CHUNK_DIRECTORY * sizeof(uint64_t *));
+  for (uint64_t i = CHUNK_SIZE / 2; i < CHUNK_ARENA * CHUNK_SIZE * 4; ++i) {
+    storage.push_back(i);
+  }
+  ASSERT_EQ(storage.size(), CHUNK_ARENA * CHUNK_SIZE * 4);
+  for (size_t i = 0; i < storage.size(); i += CHUNK_SIZE / 4 - 1) {
+    ASSERT_EQ(storage[i], i);
+  }
+  PrimesCache cache;
+  cache.fill(MAX_NUMBER, 1);
+  EXPECT_TRUE(std::equal(real_primes.begin(), real_primes.end(),
+                         cache.begin()));
+}
+
+TEST(PrimesCache, stats) {
+  PrimesCache obj;
+  PrimesCacheStats stats = obj.stats();
+  EXPECT_EQ(stats.size, 309u);
+  EXPECT_EQ(stats.sectors, 0u);
+  obj.add_primes();
+  obj.add_primes();
+  EXPECT_EQ(obj[10], real_primes[10]);
+  EXPECT_EQ(obj(20), real_primes[20]);
+  EXPECT_EQ(obj(200000), real_primes[200000]);
+  EXPECT_EQ(obj[600000], real_primes[600000]);
+  stats = obj.stats();
+  EXPECT_EQ(stats.size, obj.size());
+  EXPECT_EQ(stats.last_checked, obj.last_checked());
+  EXPECT_GE(stats.capacity, stats.size);
+  EXPECT_GE(stats.memory, stats.capacity * sizeof(uint32_t));
+  EXPECT_EQ(stats.sectors, (obj.last_checked() + 1) / SECTOR_SIZE);
+  EXPECT_GT(stats.sieve_ns, 0u);
+  EXPECT_GE(stats.grows, 1u);
+  EXPECT_EQ(stats.hits, 2u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.transient, 1u);
+  std::vector<std::thread> readers;
+  for (uint32_t t = 0; t < 4; ++t) {
+    readers.emplace_back([&obj]() {
+      for (uint32_t i = 0; i < 10000; ++i) {
+        obj(i);
+      }
+    });
+  }
+  for (std::thread &thread : readers) {
+    thread.join();
+  }
+  EXPECT_EQ(obj.stats().hits, 40002u);
+  std::string json = to_json(stats);
+  EXPECT_EQ(json.front(), '{');
+  EXPECT_NE(json.find("\"transient\": 1}"), std::string::npos);
+  CompactPrimesCache compact;
+  compact.fill(3000000);
+  EXPECT_GT(compact.stats().memory, 0u);
+  EXPECT_LT(compact.stats().memory, compact.size() * sizeof(uint32_t));
+}
+
+TEST(PrimesCache, prefetch) {
+  {
+    PrimesCache cache;
+    ASSERT_TRUE(cache.prefetch(4));
+    for (uint32_t i = 0; i < real_primes.size(); ++i) {
+      ASSERT_EQ(cache[i], real_primes[i]);
+    }
+    EXPECT_GE(cache.last_checked(), real_primes.back());
+    ASSERT_TRUE(cache.prefetch(0));
+    uint32_t last = cache.last_checked();
+    EXPECT_EQ(cache[0], 2u);
+    EXPECT_EQ(cache.last_checked(), last);
+    ASSERT_TRUE(cache.prefetch(2));
+  }
+  BasicPrimesCache<std::vector<uint32_t>> flat;
+  EXPECT_FALSE(flat.prefetch(4));
+  EXPECT_TRUE(flat.prefetch(0));
+}
+
+TEST(Primes, fetch) {
+  std::vector<uint32_t> block(100003);
+  Primes unbound;
+  for (uint32_t pos = 0; pos < real_primes.size(); pos += block.size()) {
+    size_t count = unbound.fetch(pos, block.size(), block.data());
+    ASSERT_EQ(count, block.size());
+    size_t expected = std::min(block.size(), real_primes.size() - pos);
+    ASSERT_TRUE(std::equal(block.begin(), block.begin() + expected,
+                           real_primes.begin() + pos));
+  }
+  Primes bounded(1000);
+  EXPECT_EQ(bounded.fetch(160, 100, block.data()), 8u);
+  EXPECT_EQ(block[7], 997u);
+  EXPECT_EQ(bounded.fetch(168, 1, block.data()), 0u);
+  CompactPrimes compact;
+  ASSERT_EQ(compact.fetch(1000, 5000, block.data()), 5000u);
+  EXPECT_TRUE(std::equal(block.begin(), block.begin() + 5000,
+                         real_primes.begin() + 1000));
+  Primes64 wide;
+  std::vector<uint64_t> values(10);
+  ASSERT_EQ(wide.fetch(999995, 10, values.data()), 10u);
+  EXPECT_TRUE(std::equal(values.begin(), values.end(),
+                         real_primes.begin() + 999995));
+}
+
+TEST(PrimesRange, windows) {
+  uint32_t bounds[][2]{{0, 0},
+                       {2, 2},
+                       {0, 100},
+                       {90, 96},
+                       {1000, 3000000},
+                       {MAX_NUMBER - 5000, MAX_NUMBER}};
+  for (auto &bound : bounds) {
+    PrimesRange range(bound[0], bound[1]);
+    std::vector<uint32_t> expected(
+        std::lower_bound(real_primes.begin(), real_primes.end(), bound[0]),
+        std::upper_bound(real_primes.begin(), real_primes.end(), bound[1]));
+    ASSERT_EQ(range.size(), expected.size());
+    EXPECT_TRUE(std::equal(range.begin(), range.end(), expected.begin()));
+  }
+  PrimesRange top(UINT32_MAX - 1000, UINT32_MAX);
+  EXPECT_EQ(top[top.size() - 1], 4294967291u);
+  EXPECT_EQ(top[top.size()], 0u);
+}
+
+TEST(PrimesRange, above_uint32) {
+  PrimesRange64 range(UINT64_C(1000000000000), UINT64_C(1000000000100));
+  std::vector<uint64_t> primes(range.begin(), range.end());
+  EXPECT_EQ(primes, (std::vector<uint64_t>{UINT64_C(1000000000039),
+                                           UINT64_C(1000000000061),
+                                           UINT64_C(1000000000063),
+                                           UINT64_C(1000000000091)}));
+}
+
+TEST(PrimesStream, bounded) {
+  const size_t budget = size_t(1) << 18;
+  PrimesStream stream(budget);
+  size_t pos = 0;
+  for (uint32_t prime : stream) {
+    ASSERT_EQ(prime, real_primes[pos]) << pos;
+    if (++pos == real_primes.size()) {
+      break;
+    }
+  }
+  EXPECT_GE(stream.size(), real_primes.size());
+  EXPECT_GT(stream.first(), 0u);
+  EXPECT_EQ(stream[0], 0u);
+  EXPECT_EQ(stream[stream.first()], real_primes[stream.first()]);
+  EXPECT_LT(stream.memory(), budget + 2 * SECTOR_SIZE / 8 + 65536);
+  PrimesStream64 stream64(0);
+  EXPECT_EQ(stream64[1000000], real_primes[1000000]);
+  EXPECT_EQ(stream64[999999], 0u);
+}
+
+TEST(PrimesIndex, sampled) {
+  PrimesIndex index(MAX_NUMBER, 1000);
+  EXPECT_EQ(index.size(), real_primes.size());
+  EXPECT_LT(index.memory(), real_primes.size() / 100 * sizeof(uint32_t));
+  for (uint32_t pos :
+       {0u, 1u, 999u, 1000u, 1001u, 123456u, index.size() - 1, index.size()}) {
+    EXPECT_EQ(index[pos], pos < real_primes.size() ? real_primes[pos] : 0u)
+        << pos;
+  }
+  for (uint32_t value : {0u, 1u, 2u, 7919u, 7920u, 1000000u, MAX_NUMBER,
+                         MAX_NUMBER - 7, UINT32_MAX}) {
+    EXPECT_EQ(index.count(value),
+              std::upper_bound(real_primes.begin(), real_primes.end(), value) -
+                  real_primes.begin())
+        << value;
+  }
+  std::string path = testing::TempDir() + "primes_index";
+  ASSERT_TRUE(index.save(path.c_str()));
+  PrimesIndex loaded;
+  EXPECT_EQ(loaded[0], 0u);
+  ASSERT_TRUE(loaded.load(path.c_str()));
+  EXPECT_EQ(loaded.step(), 1000u);
+  EXPECT_EQ(loaded.max_value(), MAX_NUMBER);
+  EXPECT_EQ(loaded[2500001], real_primes[2500001]);
+  PrimesIndex64 wrong_width;
+  EXPECT_FALSE(wrong_width.load(path.c_str()));
+  std::FILE *file = std::fopen(path.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  std::vector<char> saved(40 + 4 * ((real_primes.size() - 1) / 1000 + 1));
+  ASSERT_EQ(std::fread(saved.data(), 1, saved.size(), file), saved.size());
+  std::fclose(file);
+  auto corrupted = [&path, &saved](size_t offset, uint64_t value) {
+    std::vector<char> bytes = saved;
+    std::memcpy(bytes.data() + offset, &value, sizeof(value));
+    std::FILE *out = std::fopen(path.c_str(), "wb");
+    std::fwrite(bytes.data(), 1, bytes.size(), out);
+    std::fclose(out);
+    return path.c_str();
+  };
+  EXPECT_FALSE(loaded.load(corrupted(16, 1)));
+  EXPECT_FALSE(loaded.load(corrupted(24, UINT64_C(1) << 40)));
+  EXPECT_FALSE(loaded.load(corrupted(32, MAX_NUMBER)));
+  EXPECT_FALSE(loaded.load(corrupted(44, 0)));
+  EXPECT_EQ(loaded[2500001], real_primes[2500001]);
+  std::remove(path.c_str());
+  const uint64_t max64 = (UINT64_C(1) << 32) + 100000000;
+  PrimesIndex64 index64(max64);
+  EXPECT_EQ(index64.size(), count_primes(max64));
+  for (uint64_t value : {UINT64_C(1) << 32, max64 - 12345}) {
+    uint64_t pi = index64.count(value);
+    EXPECT_EQ(pi, count_primes(value)) << value;
+    uint64_t prime = index64[pi - 1];
+    EXPECT_TRUE(prime <= value && is_prime(prime)) << value;
+    EXPECT_GT(index64[pi], value);
+  }
+}
+
+TEST(PrimesBitmap, rank_select) {
+  PrimesBitmap bitmap(MAX_NUMBER);
+  ASSERT_EQ(bitmap.size(), real_primes.size());
+  for (uint32_t i = 0; i < real_primes.size(); ++i) {
+    ASSERT_EQ(bitmap[i], real_primes[i]);
+  }
+  EXPECT_EQ(bitmap[real_primes.size()], 0u);
+  for (uint32_t value = 0; value < 100000; ++value) {
+    bool expected = std::binary_search(real_primes.begin(), real_primes.end(),
+                                       value);
+    ASSERT_EQ(bitmap.is_prime(value), expected) << value;
+  }
+  for (uint32_t value = 0; value <= MAX_NUMBER; value += 9973) {
+    ASSERT_EQ(bitmap.pi(value),
+              std::upper_bound(real_primes.begin(), real_primes.end(),
+                               value) -
+                  real_primes.begin());
+  }
+  EXPECT_EQ(bitmap.pi(UINT64_MAX), real_primes.size());
+  EXPECT_FALSE(bitmap.is_prime(UINT64_C(4294967291)));
+  EXPECT_LT(bitmap.memory(), real_primes.size() * sizeof(uint32_t) / 4);
+  PrimesBitmap tiny(4);
+  EXPECT_EQ(tiny.size(), 2u);
+  EXPECT_EQ(tiny[1], 3u);
+  EXPECT_EQ(tiny.pi(100), 2u);
+}
+
+TEST(PrimeFilters, subsets) {
+  for (uint32_t max_value : {UINT32_C(1), UINT32_C(31), UINT32_C(2000003)}) {
+    PrimesBitmap bitmap(max_value);
+    auto last = std::upper_bound(real_primes.begin(), real_primes.end(),
+                                 max_value);
+    auto prime = [last](uint64_t value) {
+      return std::binary_search(real_primes.begin(), last, value);
+    };
+    std::vector<uint64_t> super, twins, germain, found;
+    for (auto it = real_primes.begin(); it != last; ++it) {
+      if (prime(static_cast<uint64_t>(it - real_primes.begin()) + 1)) {
+        super.push_back(*it);
+      }
+      if (prime(*it + UINT64_C(2))) {
+        twins.push_back(*it);
+      }
+      if (prime(UINT64_C(2) * *it + 1)) {
+        germain.push_back(*it);
+      }
+    }
+    auto collect = [&found](uint64_t value) { found.push_back(value); };
+    for_each_super_prime(bitmap, collect);
+    EXPECT_EQ(found, super) << max_value;
+    found.clear();
+    for_each_twin_prime(bitmap, collect);
+    EXPECT_EQ(found, twins) << max_value;
+    found.clear();
+    for_each_sophie_germain(bitmap, collect);
+    EXPECT_EQ(found, germain) << max_value;
+    found.clear();
+  }
+  std::vector<uint64_t> mersenne;
+  for_each_mersenne(UINT64_MAX,
+                    [&mersenne](uint64_t value) { mersenne.push_back(value); });
+  std::vector<uint64_t> expected;
+  for (uint32_t exponent : {2, 3, 5, 7, 13, 17, 19, 31, 61}) {
+    expected.push_back((UINT64_C(1) << exponent) - 1);
+  }
+  EXPECT_EQ(mersenne, expected);
+  EXPECT_FALSE(lucas_lehmer(11));
+  EXPECT_FALSE(lucas_lehmer(4));
+}
+
+TEST(PrimeCount, small) {
+  for (uint32_t x = 0; x < 100000; x += (x < 1000 ? 1 : 997)) {
+    uint32_t expected = static_cast<uint32_t>(
+        std::upper_bound(real_primes.begin(), real_primes.end(), x) -
+        real_primes.begin());
+    EXPECT_EQ(count_primes(x), expected) << x;
+  }
+  EXPECT_EQ(count_primes(MAX_NUMBER),
+            static_cast<uint32_t>(real_primes.size()));
+  EXPECT_EQ(count_primes(1000u, 2000u), 135u);
+  EXPECT_EQ(count_primes(2000u, 1000u), 0u);
+}
+
+TEST(PrimeCount, large) {
+  EXPECT_EQ(count_primes(UINT32_MAX), 203280221u);
+  EXPECT_EQ(count_primes(UINT64_C(1000000000000)), UINT64_C(37607912018));
+  EXPECT_EQ(count_primes(UINT64_C(1000000000000), UINT64_C(1000000000100)),
+            UINT64_C(4));
+}
+
+TEST(Primality, single) {
+  std::vector<bool> expected(100000, false);
+  for (uint32_t prime : real_primes) {
+    if (prime >= expected.size()) {
+      break;
+    }
+    expected[prime] = true;
+  }
+  for (uint32_t n = 0; n < expected.size(); ++n) {
+    EXPECT_EQ(is_prime(n), expected[n]) << n;
+  }
+  EXPECT_TRUE(is_prime(4294967291u));
+  EXPECT_FALSE(is_prime(4294967295u));
+  EXPECT_FALSE(is_prime(3215031751u));
+  EXPECT_TRUE(is_prime(UINT64_C(18446744073709551557)));
+  EXPECT_FALSE(is_prime(UINT64_C(18446744073709551615)));
+  EXPECT_FALSE(is_prime(UINT64_C(3825123056546413051)));
+  EXPECT_TRUE(is_prime(UINT64_C(1000000000039)));
+}
+
+TEST(Primality, batch) {
+  std::vector<uint32_t> values;
+  for (uint32_t n = MAX_NUMBER - 100000; n <= MAX_NUMBER; ++n) {
+    values.push_back(n);
+  }
+  std::vector<bool> result;
+  is_prime(values.data(), values.data() + values.size(), result);
+  ASSERT_EQ(result.size(), values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(result[i], std::binary_search(real_primes.begin(),
+                                            real_primes.end(), values[i]));
+  }
+  std::vector<uint32_t> strong{3215031751u, 25326001u, 3221225473u,
+                               2013265921u, 4294967291u};
+  is_prime(strong.data(), strong.data() + strong.size(), result);
+  EXPECT_EQ(result, (std::vector<bool>{false, false, true, true, true}));
+  std::vector<uint64_t> wide{UINT64_C(1000000000039), UINT64_C(1000000000041),
+                             UINT64_C(3825123056546413051), 97, 1,
+                             UINT64_C(18446744073709551557)};
+  is_prime(wide.data(), wide.data() + wide.size(), result);
+  EXPECT_EQ(result,
+            (std::vector<bool>{true, false, false, true, false, true}));
+  wide.clear();
+  for (uint64_t n = (UINT64_C(1) << 40) + 1; wide.size() < 1001; n += 2) {
+    wide.push_back(n);
+  }
+  is_prime(wide.data(), wide.data() + wide.size(), result);
+  for (size_t i = 0; i < wide.size(); ++i) {
+    EXPECT_EQ(result[i], is_prime(wide[i])) << wide[i];
+  }
+}
+
 TEST(Primes_iterators_test, general) {
   Primes obj;
   auto begin = obj.begin();
@@ -157,3 +682,173 @@ TEST(Primes_iterators_test, general) {
   EXPECT_EQ(end, end + 100);
   EXPECT_EQ(end, end - 100);
 }
+
+TEST(PrimesWriter, output) {
+  char digits[DECIMAL_DIGITS];
+  for (uint64_t value : {UINT64_C(0), UINT64_C(9), UINT64_C(10), UINT64_C(99),
+                         UINT64_C(4294967291), UINT64_MAX}) {
+    EXPECT_EQ(std::string(digits, format_decimal(value, digits)),
+              std::to_string(value));
+  }
+  FILE *file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  std::string expected;
+  {
+    PrimesWriter writer(fileno(file));
+    for (uint32_t prime : real_primes) {
+      writer.write(prime);
+      expected += std::to_string(prime) + '\n';
+    }
+    EXPECT_EQ(writer.count(), real_primes.size());
+  }
+  std::string written(expected.size() + 1, '\0');
+  std::rewind(file);
+  written.resize(std::fread(&written[0], 1, written.size(), file));
+  std::fclose(file);
+  EXPECT_EQ(written, expected);
+}
+
+TEST(PrimeReducers, fused) {
+  PrimeCounter counter;
+  PrimeSum sum;
+  GapStats gaps;
+  reduce_primes(0, MAX_NUMBER, counter, sum, gaps);
+  EXPECT_EQ(counter.count(), real_primes.size());
+  uint64_t expected_sum = 0;
+  uint64_t max_gap = 0, max_gap_start = 0, twins = 0;
+  for (size_t i = 0; i < real_primes.size(); ++i) {
+    expected_sum += real_primes[i];
+    if (i == 0) {
+      continue;
+    }
+    uint64_t gap = real_primes[i] - real_primes[i - 1];
+    twins += gap == 2;
+    if (gap > max_gap) {
+      max_gap = gap;
+      max_gap_start = real_primes[i - 1];
+    }
+  }
+  EXPECT_EQ(sum.sum(), expected_sum);
+  EXPECT_EQ(gaps.max_gap(), max_gap);
+  EXPECT_EQ(gaps.max_gap_start(), max_gap_start);
+  EXPECT_EQ(gaps.twins(), twins);
+  EXPECT_EQ(gaps.histogram().size(), max_gap + 1);
+  PrimeCounter window;
+  reduce_primes(UINT64_C(1) << 40, (UINT64_C(1) << 40) + 10000000, window);
+  EXPECT_EQ(window.count(), count_primes(UINT64_C(1) << 40,
+                                         (UINT64_C(1) << 40) + 10000000));
+}
+
+TEST(WheelSieve, resume) {
+  const uint64_t window = sieve_window() * WHEEL_SIZE;
+  const uint64_t lengths[]{1, 29, 31, 1000, 3 * window + 7, window - 1, 12345};
+  WheelSieve sieve;
+  WheelSieve split;
+  for (uint64_t start : {UINT64_C(1000), UINT64_C(10000000000000) - 12345}) {
+    uint64_t lo = start;
+    for (size_t i = 0; i < 14; ++i) {
+      uint64_t hi = lo + lengths[i % 7] - 1;
+      size_t base = static_cast<size_t>(
+          std::upper_bound(real_primes.begin(), real_primes.end(),
+                           integer_sqrt(hi)) -
+          real_primes.begin());
+      sieve.sieve(lo, hi, real_primes.data(), real_primes.data() + base);
+      WheelSieve fresh;
+      fresh.sieve(lo, hi, real_primes.data(), real_primes.data() + base);
+      ASSERT_EQ(sieve.bitmap(), fresh.bitmap()) << lo << ' ' << hi;
+      size_t head = std::min<size_t>(base, SMALL_PRIMES_COUNT);
+      split.sieve(lo, hi, SMALL_PRIMES.begin(), SMALL_PRIMES.end(),
+                  real_primes.data() + head, real_primes.data() + base);
+      ASSERT_EQ(split.bitmap(), fresh.bitmap()) << lo << ' ' << hi;
+      sieve.for_each_prime(
+          [](uint64_t prime) { ASSERT_TRUE(is_prime(prime)) << prime; });
+      lo = hi + 1;
+    }
+  }
+}
+
+TEST(SmallPrimes, table) {
+  static_assert(SMALL_PRIMES.values[0] == 2 && SMALL_PRIMES.values[6] == 17,
+                "SMALL_PRIMES must be computed at compile time");
+  std::vector<uint32_t> expected(
+      real_primes.begin(),
+      std::lower_bound(real_primes.begin(), real_primes.end(),
+                       SMALL_PRIMES_LIMIT));
+  EXPECT_EQ(std::vector<uint32_t>(SMALL_PRIMES.begin(), SMALL_PRIMES.end()),
+            expected);
+  for (uint32_t limit : {0u, 1u, 2u, 65520u, 65521u, 65536u, 1000000u}) {
+    std::vector<uint32_t> primes = primes_up_to(limit);
+    EXPECT_EQ(primes,
+              std::vector<uint32_t>(
+                  real_primes.begin(),
+                  std::upper_bound(real_primes.begin(), real_primes.end(),
+                                   limit)))
+        << limit;
+  }
+}
+
+TEST(WheelSieve, ranges) {
+  WheelSieve sieve;
+  std::vector<uint32_t> base(real_primes.begin(),
+                             std::upper_bound(real_primes.begin(),
+                                              real_primes.end(), 65536));
+  uint32_t bounds[][2]{{0, 1}, {0, 100}, {7, 7}, {30, 59}, {1000, 99999},
+                       {9600000, 9800000}};
+  for (auto &bound : bounds) {
+    std::vector<uint32_t> primes;
+    sieve.sieve(bound[0], bound[1], base.data(), base.data() + base.size());
+    sieve.for_each_prime([&primes](uint64_t prime) {
+      primes.push_back(static_cast<uint32_t>(prime));
+    });
+    std::vector<uint32_t> expected(
+        std::lower_bound(real_primes.begin(), real_primes.end(), bound[0]),
+        std::upper_bound(real_primes.begin(), real_primes.end(), bound[1]));
+    EXPECT_EQ(primes, expected);
+  }
+  uint64_t lo = (UINT64_C(1) << 34) - 5000;
+  uint64_t hi = (UINT64_C(1) << 34) + 5000;
+  std::vector<uint64_t> primes;
+  std::vector<uint64_t> expected;
+  sieve.sieve(lo, hi, real_primes.data(),
+              real_primes.data() + real_primes.size());
+  sieve.for_each_prime([&primes](uint64_t prime) { primes.push_back(prime); });
+  for (uint64_t value = lo; value <= hi; ++value) {
+    bool is_prime = true;
+    for (uint64_t pr : real_primes) {
+      if (pr * pr > value || !(is_prime = value % pr != 0)) {
+        break;
+      }
+    }
+    if (is_prime) {
+      expected.push_back(value);
+    }
+  }
+  EXPECT_EQ(primes, expected);
+}
+
+TEST(SieveKernels, agree) {
+  std::vector<SieveKernels> kernels = supported_sieve_kernels();
+  ASSERT_STREQ(kernels.front().isa, "scalar");
+  EXPECT_STREQ(sieve_kernels().isa, kernels.back().isa);
+  std::vector<uint8_t> data(1000);
+  uint32_t state = 1;
+  for (uint8_t &byte : data) {
+    state = state * UINT32_C(1664525) + UINT32_C(1013904223);
+    byte = static_cast<uint8_t>(state >> 24);
+  }
+  data[10] = 0;
+  data[11] = 0xFF;
+  const uint64_t base = UINT64_C(1) << 40;
+  for (size_t bytes : {0, 1, 7, 8, 31, 33, 64, 65, 1000}) {
+    std::vector<uint64_t> expected(8 * bytes + 1);
+    expected.resize(
+        kernels.front().decode(data.data(), bytes, base, expected.data()));
+    for (SieveKernels const &kernel : kernels) {
+      EXPECT_EQ(kernel.count(data.data(), bytes), expected.size())
+          << kernel.isa << ' ' << bytes;
+      std::vector<uint64_t> values(8 * bytes + 1);
+      values.resize(kernel.decode(data.data(), bytes, base, values.data()));
+      EXPECT_EQ(values, expected) << kernel.isa << ' ' << bytes;
+    }
+  }
+}
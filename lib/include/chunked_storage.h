@@ -0,0 +1,155 @@
+#ifndef CHUNKED_STORAGE_H
+#define CHUNKED_STORAGE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "index_iterator.h"
+
+namespace {
+/**
+ * @brief Количество значений в одном блоке \link BasicChunkedStorage
+ * \endlink.
+ */
+const size_t CHUNK_SIZE{65536};
+/**
+ * @brief Количество указателей на блоки в одной странице каталога \link
+ * BasicChunkedStorage \endlink и количество страниц каталога.
+ */
+const size_t CHUNK_DIRECTORY{1024};
+/**
+ * @brief Минимальное количество блоков, выделяемых \link BasicChunkedStorage
+ * \endlink одним отображением памяти.
+ */
+const size_t CHUNK_ARENA{8};
+} // namespace
+
+/**
+ * @brief Контейнер из блоков фиксированного размера, значения в котором
+ * никогда не перемещаются.
+ *
+ * Значения хранятся в блоках по CHUNK_SIZE, указатели на блоки - в
+ * двухуровневом каталоге фиксированного размера, поэтому добавление значения
+ * не копирует уже записанные данные. Размер публикуется атомарно после
+ * записи значения: один поток может добавлять значения, пока другие потоки
+ * без блокировок читают значения на позициях меньше \link
+ * BasicChunkedStorage::size() \endlink. Вмещает до CHUNK_SIZE *
+ * CHUNK_DIRECTORY * CHUNK_DIRECTORY значений.
+ *
+ * Блоки нарезаются из областей памяти, выделенных mmap по CHUNK_ARENA блоков
+ * или сразу на весь объем, заданный \link BasicChunkedStorage::reserve()
+ * \endlink. Области выровнены по 2 МБ и помечены как подходящие для
+ * больших страниц, физическая память выделяется при первой записи.
+ */
+template <typename T> class BasicChunkedStorage {
+public:
+  /**
+   * @brief Тип хранимых значений.
+   */
+  using value_type = T;
+  /**
+   * @brief Тип итератора для \link BasicChunkedStorage \endlink.
+   */
+  using const_iterator = IndexIterator<BasicChunkedStorage>;
+
+  /**
+   * @brief Конструктор пустого контейнера.
+   */
+  BasicChunkedStorage() noexcept;
+  /**
+   * @brief Деструктор, освобождающий выделенные области.
+   */
+  ~BasicChunkedStorage();
+
+  BasicChunkedStorage(BasicChunkedStorage const &) = delete;
+  BasicChunkedStorage &operator=(BasicChunkedStorage const &) = delete;
+
+  /**
+   * @brief Добавляет значение в конец контейнера.
+   * @param value
+   *
+   * Не должна вызываться одновременно из нескольких потоков.
+   */
+  void push_back(T value);
+  /**
+   * @brief Выделяет блоки для хранения count значений.
+   * @param count
+   *
+   * Сначала занимает свободные блоки текущей области, недостающие блоки
+   * выделяет одной новой областью. Уже выделенные блоки не перемещаются.
+   * Не должна вызываться одновременно с \link
+   * BasicChunkedStorage::push_back() \endlink.
+   */
+  void reserve(size_t count);
+
+  /**
+   * @brief Копирует значения на позициях [pos, pos + count) в out.
+   * @param pos
+   * @param count
+   * @param out
+   *
+   * Копирует целыми участками блоков через std::memcpy.
+   */
+  void copy(size_t pos, size_t count, T *out) const noexcept;
+
+  /**
+   * @param pos
+   * @return Значение на позиции pos.
+   */
+  T operator[](size_t pos) const noexcept {
+    return directory_[pos / (CHUNK_SIZE * CHUNK_DIRECTORY)]
+                     [pos / CHUNK_SIZE % CHUNK_DIRECTORY][pos % CHUNK_SIZE];
+  }
+  /**
+   * @return Последнее добавленное значение.
+   */
+  T back() const noexcept;
+  /**
+   * @return Количество опубликованных значений.
+   */
+  size_t size() const noexcept;
+  /**
+   * @return Количество значений, которое можно хранить без отображения новых
+   * областей памяти.
+   */
+  size_t capacity() const noexcept;
+  /**
+   * @return Объем отображенных областей и каталога блоков в байтах.
+   */
+  size_t memory() const noexcept;
+  /**
+   * @return true если контейнер пуст, false - иначе.
+   */
+  bool empty() const noexcept;
+
+  /**
+   * @return Итератор на начало контейнера.
+   */
+  const_iterator begin() const noexcept;
+  /**
+   * @return Итератор на конец контейнера.
+   */
+  const_iterator end() const noexcept;
+
+private:
+  void map_arena(size_t chunks);
+  void add_chunk();
+
+  std::unique_ptr<T *[]> directory_[CHUNK_DIRECTORY];
+  std::atomic<size_t> size_;
+  size_t chunks_;
+  std::vector<std::pair<void *, size_t>> regions_;
+  T *arena_begin_;
+  T *arena_end_;
+};
+
+/**
+ * @brief Блочное хранилище простых чисел до UINT32_MAX.
+ */
+using ChunkedStorage = BasicChunkedStorage<uint32_t>;
+
+#endif // CHUNKED_STORAGE_H
@@ -0,0 +1,283 @@
+#ifndef GAP_STORAGE_H
+#define GAP_STORAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace {
+/**
+ * @brief Шаг, с которым \link BasicGapStorage \endlink запоминает абсолютные
+ * значения.
+ */
+const uint32_t GAP_SAMPLE{64};
+} // namespace
+
+/**
+ * @brief Контейнер для возрастающей последовательности простых чисел,
+ * хранящий разности между соседними элементами.
+ *
+ * Разность хранится в одном байте как половина ее значения (3 - 2
+ * единственная нечетная разность и хранится как 0). Разности больше 508
+ * записываются в три байта: 255 и половина разности. До UINT32_MAX такие
+ * разности не встречаются. Каждое GAP_SAMPLE-ое значение и его смещение в
+ * массиве разностей запоминаются целиком, поэтому доступ по индексу требует
+ * не более GAP_SAMPLE - 1 сложений. Вместе с образцами одно значение
+ * занимает 1 + (sizeof(T) + sizeof(size_t)) / GAP_SAMPLE байт: около 1.19
+ * байта для uint32_t и 1.25 байта для uint64_t на 64-битной платформе.
+ */
+template <typename T> class BasicGapStorage {
+public:
+  /**
+   * @brief Тип хранимых значений.
+   */
+  using value_type = T;
+
+  /**
+   * @brief Класс-итератор для \link BasicGapStorage \endlink.
+   */
+  class const_iterator {
+  public:
+    /**
+     * @brief Тип разницы между итераторами для \link BasicGapStorage
+     * \endlink.
+     */
+    using difference_type = std::ptrdiff_t;
+    /**
+     * @brief Тип значения по итератору для \link BasicGapStorage \endlink.
+     */
+    using value_type = T;
+    /**
+     * @brief Тип указателя на значение по итератору для \link BasicGapStorage
+     * \endlink.
+     */
+    using pointer = const T *;
+    /**
+     * @brief Тип ссылки на значение по итератору для \link BasicGapStorage
+     * \endlink.
+     */
+    using reference = T;
+    /**
+     * @brief Вид итератора для \link BasicGapStorage \endlink.
+     */
+    using iterator_category = std::random_access_iterator_tag;
+
+    /**
+     * @brief Конструктор итератора, не связанного с контейнером.
+     */
+    const_iterator() noexcept;
+    /**
+     * @brief Конструктор.
+     * @param owner
+     * @param pos
+     *
+     * Создает итератор по контейнеру owner на позицию pos.
+     */
+    const_iterator(BasicGapStorage const *owner, size_t pos) noexcept;
+
+    /**
+     * @param diff
+     * @return Итератор на позицию pos + diff.
+     */
+    const_iterator &operator+=(difference_type diff) noexcept;
+    /**
+     * @param diff
+     * @return Итератор на позицию pos - diff.
+     */
+    const_iterator &operator-=(difference_type diff) noexcept;
+    /**
+     * @return Итератор на позицию pos + 1.
+     */
+    const_iterator &operator++() noexcept;
+    /**
+     * @return Итератор на позицию pos.
+     */
+    const_iterator operator++(int) noexcept;
+    /**
+     * @return Итератор на позицию pos - 1.
+     */
+    const_iterator &operator--() noexcept;
+    /**
+     * @return Итератор на позицию pos.
+     */
+    const_iterator operator--(int) noexcept;
+
+    /**
+     * @param it
+     * @param diff
+     * @return Итератор на позицию it.pos + diff.
+     */
+    friend const_iterator operator+(const_iterator const &it,
+                                    difference_type diff) noexcept {
+      return const_iterator(it) += diff;
+    }
+    /**
+     * @param diff
+     * @param it
+     * @return Итератор на позицию it.pos + diff.
+     */
+    friend const_iterator operator+(difference_type diff,
+                                    const_iterator const &it) noexcept {
+      return it + diff;
+    }
+    /**
+     * @param it
+     * @param diff
+     * @return Итератор на позицию it.pos - diff.
+     */
+    friend const_iterator operator-(const_iterator const &it,
+                                    difference_type diff) noexcept {
+      return const_iterator(it) -= diff;
+    }
+    /**
+     * @param lhs
+     * @param rhs
+     * @return Разницу между позициями на которые указывают итераторы.
+     */
+    friend difference_type operator-(const_iterator const &lhs,
+                                     const_iterator const &rhs) noexcept {
+      return static_cast<difference_type>(lhs.pos_) -
+             static_cast<difference_type>(rhs.pos_);
+    }
+
+    /**
+     * @param lhs
+     * @param rhs
+     * @return true если позиции на которые указывают итераторы равны, false -
+     * иначе.
+     */
+    friend bool operator==(const_iterator const &lhs,
+                           const_iterator const &rhs) noexcept {
+      return lhs.pos_ == rhs.pos_;
+    }
+    /**
+     * @param lhs
+     * @param rhs
+     * @return false если позиции на которые указывают итераторы равны, true -
+     * иначе.
+     */
+    friend bool operator!=(const_iterator const &lhs,
+                           const_iterator const &rhs) noexcept {
+      return lhs.pos_ != rhs.pos_;
+    }
+    /**
+     * @param lhs
+     * @param rhs
+     * @return true если позиция lhs меньше позиции rhs, false - иначе.
+     */
+    friend bool operator<(const_iterator const &lhs,
+                          const_iterator const &rhs) noexcept {
+      return lhs.pos_ < rhs.pos_;
+    }
+    /**
+     * @param lhs
+     * @param rhs
+     * @return true если позиция lhs больше позиции rhs, false - иначе.
+     */
+    friend bool operator>(const_iterator const &lhs,
+                          const_iterator const &rhs) noexcept {
+      return rhs < lhs;
+    }
+    /**
+     * @param lhs
+     * @param rhs
+     * @return true если позиция lhs не меньше позиции rhs, false - иначе.
+     */
+    friend bool operator>=(const_iterator const &lhs,
+                           const_iterator const &rhs) noexcept {
+      return !(lhs < rhs);
+    }
+    /**
+     * @param lhs
+     * @param rhs
+     * @return true если позиция lhs не больше позиции rhs, false - иначе.
+     */
+    friend bool operator<=(const_iterator const &lhs,
+                           const_iterator const &rhs) noexcept {
+      return !(lhs > rhs);
+    }
+
+    /**
+     * @return Значение на позиции, на которую указывает итератор.
+     */
+    T operator*() const noexcept;
+    /**
+     * @param diff
+     * @return Значение на позиции pos + diff.
+     */
+    T operator[](difference_type diff) const noexcept;
+
+  private:
+    BasicGapStorage const *owner_;
+    size_t pos_;
+    size_t offset_;
+    T value_;
+  };
+
+  /**
+   * @brief Конструктор пустого контейнера.
+   */
+  BasicGapStorage() noexcept;
+
+  /**
+   * @brief Добавляет значение в конец контейнера.
+   * @param value
+   *
+   * Значение должно быть простым числом, большим последнего добавленного.
+   */
+  void push_back(T value);
+
+  /**
+   * @param pos
+   * @return Значение на позиции pos.
+   */
+  T operator[](size_t pos) const noexcept;
+  /**
+   * @return Последнее добавленное значение.
+   */
+  T back() const noexcept;
+  /**
+   * @return Количество хранимых значений.
+   */
+  size_t size() const noexcept;
+  /**
+   * @return Количество значений, которое можно добавить без выделения
+   * памяти, если все следующие разности помещаются в один байт, плюс \link
+   * BasicGapStorage::size() \endlink.
+   */
+  size_t capacity() const noexcept;
+  /**
+   * @return Объем выделенной памяти в байтах.
+   */
+  size_t memory() const noexcept;
+  /**
+   * @return true если контейнер пуст, false - иначе.
+   */
+  bool empty() const noexcept;
+
+  /**
+   * @return Итератор на начало контейнера.
+   */
+  const_iterator begin() const noexcept;
+  /**
+   * @return Итератор на конец контейнера.
+   */
+  const_iterator end() const noexcept;
+
+private:
+  T read_gap(size_t &offset) const noexcept;
+
+  std::vector<uint8_t> gaps_;
+  std::vector<T> samples_;
+  std::vector<size_t> offsets_;
+  size_t size_;
+  T back_;
+};
+
+/**
+ * @brief Хранилище разностей между простыми числами до UINT32_MAX.
+ */
+using GapStorage = BasicGapStorage<uint32_t>;
+
+#endif // GAP_STORAGE_H
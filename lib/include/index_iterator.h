@@ -0,0 +1,203 @@
+#ifndef INDEX_ITERATOR_H
+#define INDEX_ITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+
+/**
+ * @brief Итератор произвольного доступа по контейнеру, читающий значения
+ * через Container::operator[](size_t).
+ *
+ * Хранит только указатель на контейнер и позицию, поэтому остается
+ * действительным при добавлении новых значений в контейнер.
+ */
+template <typename Container> class IndexIterator {
+public:
+  /**
+   * @brief Тип разницы между итераторами для контейнера.
+   */
+  using difference_type = std::ptrdiff_t;
+  /**
+   * @brief Тип значения по итератору для контейнера.
+   */
+  using value_type = typename Container::value_type;
+  /**
+   * @brief Тип указателя на значение по итератору для контейнера.
+   */
+  using pointer = const value_type *;
+  /**
+   * @brief Тип ссылки на значение по итератору для контейнера.
+   */
+  using reference = value_type;
+  /**
+   * @brief Вид итератора для контейнера.
+   */
+  using iterator_category = std::random_access_iterator_tag;
+
+  /**
+   * @brief Конструктор итератора, не связанного с контейнером.
+   */
+  IndexIterator() noexcept : owner_{nullptr}, pos_{0} {}
+  /**
+   * @brief Конструктор.
+   * @param owner
+   * @param pos
+   *
+   * Создает итератор по контейнеру owner на позицию pos.
+   */
+  IndexIterator(Container const *owner, size_t pos) noexcept
+      : owner_{owner}, pos_{pos} {}
+
+  /**
+   * @param diff
+   * @return Итератор на позицию pos + diff.
+   */
+  IndexIterator &operator+=(difference_type diff) noexcept {
+    pos_ += static_cast<size_t>(diff);
+    return *this;
+  }
+  /**
+   * @param diff
+   * @return Итератор на позицию pos - diff.
+   */
+  IndexIterator &operator-=(difference_type diff) noexcept {
+    return *this += -diff;
+  }
+  /**
+   * @return Итератор на позицию pos + 1.
+   */
+  IndexIterator &operator++() noexcept { return *this += 1; }
+  /**
+   * @return Итератор на позицию pos.
+   */
+  IndexIterator operator++(int) noexcept {
+    IndexIterator tmp(*this);
+    ++*this;
+    return tmp;
+  }
+  /**
+   * @return Итератор на позицию pos - 1.
+   */
+  IndexIterator &operator--() noexcept { return *this -= 1; }
+  /**
+   * @return Итератор на позицию pos.
+   */
+  IndexIterator operator--(int) noexcept {
+    IndexIterator tmp(*this);
+    --*this;
+    return tmp;
+  }
+
+  /**
+   * @param it
+   * @param diff
+   * @return Итератор на позицию it.pos + diff.
+   */
+  friend IndexIterator operator+(IndexIterator const &it,
+                                difference_type diff) noexcept {
+    return IndexIterator(it) += diff;
+  }
+  /**
+   * @param diff
+   * @param it
+   * @return Итератор на позицию it.pos + diff.
+   */
+  friend IndexIterator operator+(difference_type diff,
+                                IndexIterator const &it) noexcept {
+    return it + diff;
+  }
+  /**
+   * @param it
+   * @param diff
+   * @return Итератор на позицию it.pos - diff.
+   */
+  friend IndexIterator operator-(IndexIterator const &it,
+                                difference_type diff) noexcept {
+    return IndexIterator(it) -= diff;
+  }
+  /**
+   * @param lhs
+   * @param rhs
+   * @return Разницу между позициями на которые указывают итераторы.
+   */
+  friend difference_type operator-(IndexIterator const &lhs,
+                                   IndexIterator const &rhs) noexcept {
+    return static_cast<difference_type>(lhs.pos_) -
+           static_cast<difference_type>(rhs.pos_);
+  }
+
+  /**
+   * @param lhs
+   * @param rhs
+   * @return true если позиции на которые указывают итераторы равны, false -
+   * иначе.
+   */
+  friend bool operator==(IndexIterator const &lhs,
+                         IndexIterator const &rhs) noexcept {
+    return lhs.pos_ == rhs.pos_;
+  }
+  /**
+   * @param lhs
+   * @param rhs
+   * @return false если позиции на которые указывают итераторы равны, true -
+   * иначе.
+   */
+  friend bool operator!=(IndexIterator const &lhs,
+                         IndexIterator const &rhs) noexcept {
+    return lhs.pos_ != rhs.pos_;
+  }
+  /**
+   * @param lhs
+   * @param rhs
+   * @return true если позиция lhs меньше позиции rhs, false - иначе.
+   */
+  friend bool operator<(IndexIterator const &lhs,
+                        IndexIterator const &rhs) noexcept {
+    return lhs.pos_ < rhs.pos_;
+  }
+  /**
+   * @param lhs
+   * @param rhs
+   * @return true если позиция lhs больше позиции rhs, false - иначе.
+   */
+  friend bool operator>(IndexIterator const &lhs,
+                        IndexIterator const &rhs) noexcept {
+    return rhs < lhs;
+  }
+  /**
+   * @param lhs
+   * @param rhs
+   * @return true если позиция lhs не меньше позиции rhs, false - иначе.
+   */
+  friend bool operator>=(IndexIterator const &lhs,
+                         IndexIterator const &rhs) noexcept {
+    return !(lhs < rhs);
+  }
+  /**
+   * @param lhs
+   * @param rhs
+   * @return true если позиция lhs не больше позиции rhs, false - иначе.
+   */
+  friend bool operator<=(IndexIterator const &lhs,
+                         IndexIterator const &rhs) noexcept {
+    return !(lhs > rhs);
+  }
+
+  /**
+   * @return Значение на позиции, на которую указывает итератор.
+   */
+  value_type operator*() const noexcept { return (*owner_)[pos_]; }
+  /**
+   * @param diff
+   * @return Значение на позиции pos + diff.
+   */
+  value_type operator[](difference_type diff) const noexcept {
+    return *(*this + diff);
+  }
+
+private:
+  Container const *owner_;
+  size_t pos_;
+};
+
+#endif // INDEX_ITERATOR_H
@@ -0,0 +1,132 @@
+#ifndef MAPPED_STORAGE_H
+#define MAPPED_STORAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "index_iterator.h"
+
+/**
+ * @brief Контейнер для возрастающей последовательности простых чисел, начало
+ * которой отображено из файла в память.
+ *
+ * Значения из файла читаются напрямую из отображения, открытого только для
+ * чтения, поэтому страницы файла разделяются между процессами через кэш
+ * страниц. Значения, добавленные после \link BasicMappedStorage::map()
+ * \endlink, хранятся в обычном массиве после отображенной части.
+ */
+template <typename T> class BasicMappedStorage {
+public:
+  /**
+   * @brief Тип хранимых значений.
+   */
+  using value_type = T;
+
+  /**
+   * @brief Тип итератора для \link BasicMappedStorage \endlink.
+   */
+  using const_iterator = IndexIterator<BasicMappedStorage>;
+
+  /**
+   * @brief Конструктор пустого контейнера.
+   */
+  BasicMappedStorage() noexcept;
+  /**
+   * @brief Деструктор, закрывающий отображение.
+   */
+  ~BasicMappedStorage();
+
+  BasicMappedStorage(BasicMappedStorage const &) = delete;
+  BasicMappedStorage &operator=(BasicMappedStorage const &) = delete;
+
+  /**
+   * @brief Заменяет содержимое контейнера значениями из файла.
+   * @param fd
+   * @param offset
+   * @param count
+   * @return true в случае успеха, false - иначе.
+   *
+   * Отображает файл fd только для чтения и использует count значений,
+   * начинающихся со смещения offset байт. Смещение должно быть кратно
+   * sizeof(T). Дескриптор можно закрыть после вызова. В случае неудачи
+   * содержимое не меняется.
+   */
+  bool map(int fd, size_t offset, size_t count);
+
+  /**
+   * @brief Добавляет значение в конец контейнера.
+   * @param value
+   */
+  void push_back(T value);
+  /**
+   * @brief Резервирует память для хранения count значений.
+   * @param count
+   */
+  void reserve(size_t count);
+
+  /**
+   * @brief Копирует значения на позициях [pos, pos + count) в out.
+   * @param pos
+   * @param count
+   * @param out
+   */
+  void copy(size_t pos, size_t count, T *out) const noexcept;
+
+  /**
+   * @param pos
+   * @return Значение на позиции pos.
+   */
+  T operator[](size_t pos) const noexcept {
+    return pos < mapped_size_ ? mapped_[pos] : tail_[pos - mapped_size_];
+  }
+  /**
+   * @return Последнее добавленное значение.
+   */
+  T back() const noexcept;
+  /**
+   * @return Количество хранимых значений.
+   */
+  size_t size() const noexcept;
+  /**
+   * @return Количество значений, прочитанных из файла.
+   */
+  size_t mapped() const noexcept;
+  /**
+   * @return Количество значений, которое можно хранить без выделения памяти.
+   */
+  size_t capacity() const noexcept;
+  /**
+   * @return Объем отображенного файла и выделенной памяти в байтах.
+   */
+  size_t memory() const noexcept;
+  /**
+   * @return true если контейнер пуст, false - иначе.
+   */
+  bool empty() const noexcept;
+
+  /**
+   * @return Итератор на начало контейнера.
+   */
+  const_iterator begin() const noexcept;
+  /**
+   * @return Итератор на конец контейнера.
+   */
+  const_iterator end() const noexcept;
+
+private:
+  void unmap() noexcept;
+
+  void *map_;
+  size_t length_;
+  const T *mapped_;
+  size_t mapped_size_;
+  std::vector<T> tail_;
+};
+
+/**
+ * @brief Отображаемое из файла хранилище простых чисел до UINT32_MAX.
+ */
+using MappedStorage = BasicMappedStorage<uint32_t>;
+
+#endif // MAPPED_STORAGE_H
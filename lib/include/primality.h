@@ -0,0 +1,44 @@
+#ifndef PRIMALITY_H
+#define PRIMALITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+/**
+ * @brief Количество чисел, одновременно проверяемых пакетной функцией \link
+ * is_prime() \endlink.
+ */
+const uint32_t PRIMALITY_LANES{8};
+} // namespace
+
+/**
+ * @brief Проверка числа на простоту.
+ * @param n
+ * @return true если n простое, false - иначе.
+ *
+ * Делит n на малые простые числа, затем выполняет детерминированный тест
+ * Миллера-Рабина в форме Монтгомери: основания 2, 7, 61 для n < 2^32 и
+ * семь оснований Синклера для остальных 64-битных n. Решето не используется.
+ */
+template <typename T> bool is_prime(T n) noexcept;
+
+/**
+ * @brief Пакетная проверка чисел на простоту.
+ * @param first
+ * @param last
+ * @param out
+ *
+ * Записывает в out[i] результат проверки first[i]. Числа меньше 2^32, не
+ * отсеянные делением на малые простые числа, проходят тест Миллера-Рабина
+ * по одному основанию за раз группами по PRIMALITY_LANES (на процессорах с
+ * AVX2 - в 32-битных ячейках векторного регистра), и числа, не прошедшие
+ * раунд, в следующих раундах не участвуют. Остальные числа проверяются так
+ * же по раундам, но группами по 4 с чередованием независимых 64-битных
+ * умножений Монтгомери.
+ */
+template <typename T>
+void is_prime(const T *first, const T *last, std::vector<bool> &out);
+
+#endif // PRIMALITY_H
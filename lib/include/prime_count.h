@@ -0,0 +1,25 @@
+#ifndef PRIME_COUNT_H
+#define PRIME_COUNT_H
+
+#include <cstdint>
+
+/**
+ * @brief Подсчет количества простых чисел, не превышающих x.
+ * @param x
+ * @return pi(x).
+ *
+ * Использует формулу Мейсселя pi(x) = phi(x, a) + a - 1 - P2(x, a), где
+ * a = pi(x^(1/3)), и таблицу pi(y) для y <= x^(2/3), построенную решетом.
+ * Время и память - порядка x^(2/3), сами простые числа не перечисляются.
+ */
+template <typename T> T count_primes(T x);
+
+/**
+ * @brief Подсчет количества простых чисел на отрезке [lo, hi].
+ * @param lo
+ * @param hi
+ * @return pi(hi) - pi(lo - 1), либо 0 если lo > hi.
+ */
+template <typename T> T count_primes(T lo, T hi);
+
+#endif // PRIME_COUNT_H
@@ -0,0 +1,157 @@
+#ifndef PRIME_FILTERS_H
+#define PRIME_FILTERS_H
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "primes_bitmap.h"
+#include "wheel_sieve.h"
+
+namespace {
+/**
+ * @brief Биты слова карты, соответствующие остаткам 11, 17 и 29 в каждом
+ * байте: только у них p + 2 может быть взаимно просто с WHEEL_SIZE.
+ */
+const uint64_t TWIN_MASK{UINT64_C(0x9494949494949494)};
+/**
+ * @brief Биты слова карты, соответствующие остаткам 11, 23 и 29 в каждом
+ * байте: только у них 2p + 1 может быть взаимно просто с WHEEL_SIZE.
+ */
+const uint64_t SOPHIE_GERMAIN_MASK{UINT64_C(0xC4C4C4C4C4C4C4C4)};
+} // namespace
+
+/**
+ * @brief Проверка простоты числа Мерсенна 2^exponent - 1.
+ * @param exponent
+ * @return true если 2^exponent - 1 простое, false - иначе.
+ *
+ * Для простых exponent до 63 использует тест Люка-Лемера с приведением по
+ * модулю 2^exponent - 1 сдвигами. Если 128-битное умножение недоступно,
+ * показатели больше 31 проверяются через \link is_prime() \endlink.
+ */
+bool lucas_lehmer(uint32_t exponent) noexcept;
+
+/**
+ * @brief Вызывает f для каждого простого числа Мерсенна, не превышающего
+ * max_value, в порядке возрастания.
+ * @param max_value
+ * @param f
+ *
+ * Проверяются только числа 2^p - 1 для простых p, поэтому время не зависит
+ * от количества простых чисел до max_value.
+ */
+template <typename F> void for_each_mersenne(uint64_t max_value, F f);
+
+/**
+ * @brief Вызывает f для каждого простого числа с простым номером (номера
+ * начинаются с 1) из bitmap в порядке возрастания.
+ * @param bitmap
+ * @param f
+ *
+ * Номер q перебирается по той же карте, а p_q находится выборкой \link
+ * PrimesBitmap::operator[]() \endlink, поэтому время пропорционально
+ * количеству найденных чисел.
+ */
+template <typename F>
+void for_each_super_prime(PrimesBitmap const &bitmap, F f);
+
+/**
+ * @brief Вызывает f для меньшего числа p каждой пары простых чисел-близнецов
+ * (p, p + 2) из bitmap в порядке возрастания.
+ * @param bitmap
+ * @param f
+ *
+ * Пары находятся пересечением слова карты с ним же, сдвинутым на один бит,
+ * то есть по 64 бита за операцию.
+ */
+template <typename F> void for_each_twin_prime(PrimesBitmap const &bitmap, F f);
+
+/**
+ * @brief Вызывает f для каждого простого числа p из bitmap, для которого
+ * 2p + 1 тоже простое и не превышает \link PrimesBitmap::max_value()
+ * \endlink, в порядке возрастания.
+ * @param bitmap
+ * @param f
+ *
+ * Остатки, при которых 2p + 1 делится на 3 или 5, отбрасываются маской слова
+ * целиком, для остальных проверяется бит 2p + 1.
+ */
+template <typename F>
+void for_each_sophie_germain(PrimesBitmap const &bitmap, F f);
+
+/**
+ * @brief Вызывает f для числа, соответствующего каждому установленному биту
+ * bits слова с номером word карты \link PrimesBitmap::words() \endlink.
+ * @param bits
+ * @param word
+ * @param f
+ */
+template <typename F> void for_each_wheel_bit(uint64_t bits, size_t word, F f) {
+  uint64_t base = static_cast<uint64_t>(word) * 8 * WHEEL_SIZE;
+  for (; bits; bits &= bits - 1) {
+    size_t bit = std::bitset<64>((bits & (~bits + 1)) - 1).count();
+    f(base + bit / 8 * WHEEL_SIZE + WHEEL_RESIDUES[bit % 8]);
+  }
+}
+
+template <typename F> void for_each_mersenne(uint64_t max_value, F f) {
+  for (uint32_t exponent = 2; exponent < 64; ++exponent) {
+    uint64_t value = (UINT64_C(1) << exponent) - 1;
+    if (value > max_value) {
+      break;
+    }
+    if (lucas_lehmer(exponent)) {
+      f(value);
+    }
+  }
+}
+
+template <typename F>
+void for_each_super_prime(PrimesBitmap const &bitmap, F f) {
+  for (uint64_t pos = 0;; ++pos) {
+    uint64_t index = bitmap[pos];
+    if (!index || index > bitmap.size()) {
+      break;
+    }
+    f(bitmap[index - 1]);
+  }
+}
+
+template <typename F>
+void for_each_twin_prime(PrimesBitmap const &bitmap, F f) {
+  for (uint64_t small : {UINT64_C(3), UINT64_C(5)}) {
+    if (bitmap.is_prime(small + 2)) {
+      f(small);
+    }
+  }
+  std::vector<uint64_t> const &words = bitmap.words();
+  for (size_t i = 0; i < words.size(); ++i) {
+    uint64_t next = i + 1 < words.size() ? words[i + 1] : 0;
+    uint64_t pairs = words[i] & ((words[i] >> 1) | (next << 63)) & TWIN_MASK;
+    for_each_wheel_bit(pairs, i, f);
+  }
+}
+
+template <typename F>
+void for_each_sophie_germain(PrimesBitmap const &bitmap, F f) {
+  uint64_t limit = bitmap.max_value() / 2;
+  for (uint64_t small : {UINT64_C(2), UINT64_C(3), UINT64_C(5)}) {
+    if (small <= limit && bitmap.is_prime(2 * small + 1)) {
+      f(small);
+    }
+  }
+  std::vector<uint64_t> const &words = bitmap.words();
+  size_t last = static_cast<size_t>(limit / (8 * WHEEL_SIZE));
+  for (size_t i = 0; i <= last && i < words.size(); ++i) {
+    for_each_wheel_bit(words[i] & SOPHIE_GERMAIN_MASK, i,
+                       [&bitmap, &f, limit](uint64_t prime) {
+                         if (prime <= limit && bitmap.is_prime(2 * prime + 1)) {
+                           f(prime);
+                         }
+                       });
+  }
+}
+
+#endif // PRIME_FILTERS_H
@@ -0,0 +1,124 @@
+#ifndef PRIME_REDUCERS_H
+#define PRIME_REDUCERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "wheel_sieve.h"
+
+/**
+ * @brief Подсчет простых чисел по битовой карте отрезка.
+ */
+class PrimeCounter {
+public:
+  /**
+   * @brief Конструктор.
+   */
+  PrimeCounter() noexcept;
+
+  /**
+   * @brief Учитывает простые числа отрезка.
+   * @param segment
+   */
+  void operator()(WheelSieve const &segment) noexcept;
+
+  /**
+   * @return Количество учтенных простых чисел.
+   */
+  uint64_t count() const noexcept;
+
+private:
+  uint64_t count_;
+};
+
+/**
+ * @brief Сумма простых чисел по модулю 2^64.
+ */
+class PrimeSum {
+public:
+  /**
+   * @brief Конструктор.
+   */
+  PrimeSum() noexcept;
+
+  /**
+   * @brief Учитывает простые числа отрезка.
+   * @param segment
+   */
+  void operator()(WheelSieve const &segment) noexcept;
+
+  /**
+   * @return Сумма учтенных простых чисел.
+   */
+  uint64_t sum() const noexcept;
+
+private:
+  uint64_t sum_;
+};
+
+/**
+ * @brief Статистика разностей между соседними простыми числами.
+ *
+ * Учитывает разности, переходящие через границу отрезков, поэтому отрезки
+ * должны передаваться в порядке возрастания без пропусков.
+ */
+class GapStats {
+public:
+  /**
+   * @brief Конструктор.
+   */
+  GapStats() noexcept;
+
+  /**
+   * @brief Учитывает простые числа отрезка.
+   * @param segment
+   */
+  void operator()(WheelSieve const &segment);
+
+  /**
+   * @return Наибольшая разность между соседними простыми числами.
+   */
+  uint64_t max_gap() const noexcept;
+  /**
+   * @return Простое число, после которого встречается первая наибольшая
+   * разность.
+   */
+  uint64_t max_gap_start() const noexcept;
+  /**
+   * @return Количество пар простых чисел-близнецов.
+   */
+  uint64_t twins() const noexcept;
+  /**
+   * @return Массив, в котором элемент с индексом g равен количеству разностей,
+   * равных g.
+   */
+  const std::vector<uint64_t> &histogram() const noexcept;
+
+private:
+  std::vector<uint64_t> histogram_;
+  uint64_t last_;
+  uint64_t max_gap_;
+  uint64_t max_gap_start_;
+};
+
+/**
+ * @brief Передает каждый просеянный отрезок [lo, hi] во все reducers за один
+ * проход решета.
+ * @param lo
+ * @param hi
+ * @param reducers
+ *
+ * Каждый reducer - объект, вызываемый с const \link WheelSieve \endlink &,
+ * например \link PrimeCounter \endlink, \link PrimeSum \endlink или \link
+ * GapStats \endlink. Найденные простые числа нигде не сохраняются.
+ */
+template <typename... Reducers>
+void reduce_primes(uint64_t lo, uint64_t hi, Reducers &...reducers) {
+  for_each_segment(lo, hi, [&reducers...](WheelSieve const &segment) {
+    (void)std::initializer_list<int>{(reducers(segment), 0)...};
+  });
+}
+
+#endif // PRIME_REDUCERS_H
@@ -2,14 +2,23 @@
 #define PRIMES_H
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
-#ifdef DEBUG_MODE
-#include <chrono>
-#include <iostream>
-#endif
+#include "chunked_storage.h"
+#include "gap_storage.h"
+#include "mapped_storage.h"
+#include "small_primes.h"
+#include "wheel_sieve.h"
 
 namespace {
 /**
@@ -18,55 +27,234 @@ namespace {
 const uint32_t FIRST_SECTOR{2048};
 /**
  * @brief Размер сектора, на котором вычисляются значения при вызове \link
- * PrimesCache::add_primes() \endlink.
+ * BasicPrimesCache::add_primes() \endlink.
  */
 const uint32_t SECTOR_SIZE{1048576};
+/**
+ * @brief Количество секторов на один поток, вычисляемых за один проход \link
+ * BasicPrimesCache::fill() \endlink.
+ */
+const uint32_t THREAD_SECTORS{8};
+/**
+ * @brief Наибольшее количество простых чисел, под которое \link
+ * BasicPrimesCache::fill() \endlink заранее резервирует память.
+ */
+const uint64_t RESERVE_LIMIT{UINT64_C(1) << 28};
+/**
+ * @brief Версия формата файла, создаваемого \link BasicPrimesCache::save()
+ * \endlink.
+ */
+const uint32_t CACHE_FILE_VERSION{1};
 /**
  * @brief Первое число, квадрат которого выходит за границы UINT32_MAX.
  */
 const uint32_t UINT32_MAX_SQRT{65536};
+/**
+ * @brief Количество кэшей \link BasicPrimesCache \endlink, счетчики
+ * попаданий которых поток помнит одновременно.
+ */
+const size_t HIT_SLOTS{4};
 } // namespace
 
+/**
+ * @brief Счетчики \link BasicPrimesCache \endlink, возвращаемые \link
+ * BasicPrimesCache::stats() \endlink.
+ */
+struct PrimesCacheStats {
+  /**
+   * @brief Количество найденных и запомненных простых чисел.
+   */
+  uint64_t size;
+  /**
+   * @brief Количество чисел, которое хранилище вмещает без выделения памяти.
+   */
+  uint64_t capacity;
+  /**
+   * @brief Объем памяти хранилища, базовых простых чисел и буфера решета в
+   * байтах.
+   */
+  uint64_t memory;
+  /**
+   * @brief Последнее проверенное на простоту число.
+   */
+  uint64_t last_checked;
+  /**
+   * @brief Количество просеянных секторов размера SECTOR_SIZE.
+   */
+  uint64_t sectors;
+  /**
+   * @brief Суммарное время просеивания секторов в наносекундах.
+   */
+  uint64_t sieve_ns;
+  /**
+   * @brief Количество увеличений емкости хранилища.
+   */
+  uint64_t grows;
+  /**
+   * @brief Количество обращений, обслуженных уже найденными числами.
+   */
+  uint64_t hits;
+  /**
+   * @brief Количество обращений, дождавшихся просеивания новых секторов.
+   */
+  uint64_t misses;
+  /**
+   * @brief Количество вызовов \link BasicPrimesCache::operator()() \endlink,
+   * просеявших числа без добавления в кэш.
+   */
+  uint64_t transient;
+};
+
+/**
+ * @param stats
+ * @return stats в виде объекта JSON в одну строку. Кроме полей \link
+ * PrimesCacheStats \endlink содержит среднее время просеивания сектора
+ * sector_ns.
+ */
+std::string to_json(PrimesCacheStats const &stats);
+
 /**
  * @brief Класс для вычисления и хранения простых чисел
+ *
+ * Storage - контейнер, в котором хранятся найденные числа:
+ * std::vector<T>, \link BasicGapStorage \endlink, \link BasicMappedStorage
+ * \endlink или \link BasicChunkedStorage \endlink, где T - uint32_t или
+ * uint64_t. Новые секторы просеиваются непосредственно по \link SMALL_PRIMES
+ * \endlink и простым числам от SMALL_PRIMES_LIMIT до sqrt(T_MAX), которые
+ * хранятся в отдельном массиве по мере нахождения.
+ *
+ * Поиск новых чисел выполняется под мьютексом одним потоком. Уже найденные
+ * числа читаются без блокировки, поэтому с \link BasicChunkedStorage
+ * \endlink, который не перемещает данные при росте, кэш можно использовать
+ * из нескольких потоков одновременно. Остальные хранилища при росте
+ * перемещают данные и допускают только однопоточный доступ.
  */
-class PrimesCache {
+template <typename Storage> class BasicPrimesCache {
 public:
   /**
-   * @brief Тип итератора для \link PrimesCache \endlink.
+   * @brief Тип хранимых простых чисел.
+   */
+  using value_type = typename Storage::value_type;
+  /**
+   * @brief Тип итератора для \link BasicPrimesCache \endlink.
    */
-  using const_iterator = std::vector<uint32_t>::const_iterator;
+  using const_iterator = typename Storage::const_iterator;
 
   /**
    * @brief Конструктор.
    *
-   * При создании объекта находит все простые числа до FIRST_SECTOR.
+   * При создании объекта копирует простые числа до FIRST_SECTOR из \link
+   * SMALL_PRIMES \endlink, не просеивая.
+   */
+  BasicPrimesCache();
+  /**
+   * @brief Деструктор, останавливающий фоновый поиск.
    */
-  PrimesCache();
+  ~BasicPrimesCache();
+
+  BasicPrimesCache(BasicPrimesCache const &) = delete;
+  BasicPrimesCache &operator=(BasicPrimesCache const &) = delete;
 
   /**
    * @brief Функция генерации новых чисел.
    *
-   * При вызове находит все простые числа от \link PrimesCache::last_checked()
-   * \endlink  до \link PrimesCache::last_checked() \endlink + SECTOR_SIZE.
+   * При вызове находит все простые числа от \link
+   * BasicPrimesCache::last_checked() \endlink  до \link
+   * BasicPrimesCache::last_checked() \endlink + SECTOR_SIZE.
    */
   void add_primes();
 
+  /**
+   * @brief Функция параллельной генерации новых чисел.
+   * @param max_value
+   * @param threads
+   *
+   * Находит все простые числа до max_value, разбивая диапазон на сектора
+   * размера SECTOR_SIZE и просеивая их в threads потоках с общими базовыми
+   * простыми числами до sqrt(max_value). Потоки забирают сектора из общего
+   * счетчика короткими группами подряд идущих секторов: нагрузка
+   * распределяется динамически, а внутри группы решето продолжает позиции
+   * кратных без делений. Результат совпадает с многократным вызовом \link
+   * BasicPrimesCache::add_primes() \endlink. При threads равном 0
+   * используется std::thread::hardware_concurrency(). Если
+   * хранилище поддерживает reserve(), заранее резервирует память по верхней
+   * оценке pi(max_value), не превышающей RESERVE_LIMIT.
+   */
+  void fill(value_type max_value, uint32_t threads = 0);
+
   /**
    * В случае если простых чисел в уже сгенерированном массиве данных
    * недостаточно генерирует новые.
    * @param pos
    * @return Простое число на позии pos в случае успеха, иначе 0.
    */
-  uint32_t operator[](uint32_t pos);
+  value_type operator[](value_type pos);
   /**
    * В случае если простых чисел в уже сгенерированном массиве данных
-   * недостаточно ищет новые не выделяя при этом дополнительной памяти. После
-   * возврата найденного числа не запоминает его.
+   * недостаточно ищет новые не добавляя их в кэш: оценивает искомое число
+   * снизу, подсчитывает простые числа до оценки функцией \link count_primes()
+   * \endlink и просеивает оставшийся промежуток. После возврата найденного
+   * числа не запоминает его. Блокировка удерживается только на время
+   * копирования размера кэша и простых чисел для просеивания, поэтому поиск
+   * не задерживает других читателей и \link BasicPrimesCache::fill()
+   * \endlink. При нехватке памяти возвращает 0.
    * @param pos
    * @return Простое число на позии pos в случае успеха, иначе 0.
    */
-  uint32_t operator()(uint32_t pos) const noexcept;
+  value_type operator()(value_type pos) const noexcept;
+  /**
+   * @brief Копирует простые числа на позициях [pos, pos + count) в out.
+   * @param pos
+   * @param count
+   * @param out
+   * @return Количество скопированных чисел.
+   *
+   * Один раз дополняет кэш до pos + count чисел, после чего копирует их
+   * непрерывными участками хранилища. Меньше count чисел копируется только
+   * если простых чисел типа value_type не хватает.
+   */
+  size_t fetch(value_type pos, size_t count, value_type *out);
+
+  /**
+   * @brief Сохраняет найденные простые числа в файл.
+   * @param path
+   * @return true в случае успеха, false - иначе.
+   *
+   * Файл начинается с заголовка (сигнатура, CACHE_FILE_VERSION, размер
+   * числа в байтах, количество чисел и \link BasicPrimesCache::last_checked()
+   * \endlink), за которым следуют сами числа. Если path уже содержит начало
+   * кэша того же типа, в конец файла дописываются только новые числа, после
+   * чего обновляется заголовок. Иначе файл записывается заново через
+   * временный файл и переименование, поэтому процессы, отобразившие старый
+   * файл, продолжают работать.
+   */
+  bool save(const char *path) const;
+  /**
+   * @brief Загружает простые числа из файла, созданного \link
+   * BasicPrimesCache::save() \endlink.
+   * @param path
+   * @return true если файл подходит к кэшу, false - иначе.
+   *
+   * Если файл содержит больше чисел, чем кэш, недостающие числа добавляются
+   * в кэш без повторного просеивания. Хранилище \link BasicMappedStorage
+   * \endlink не копирует числа, а отображает файл в память.
+   */
+  bool load(const char *path);
+
+  /**
+   * @brief Включает фоновый поиск простых чисел впереди читающих потоков.
+   * @param sectors
+   * @return true в случае успеха, false - если хранилище перемещает данные
+   * при росте и не допускает чтения во время поиска.
+   *
+   * Фоновый поток поддерживает \link BasicPrimesCache::last_checked()
+   * \endlink не меньше, чем на sectors * SECTOR_SIZE впереди самого дальнего
+   * запрошенного через \link BasicPrimesCache::operator[]() \endlink
+   * простого числа, и досчитывает новые сектора, когда чтение проходит
+   * половину запаса. Поэтому последовательный обход почти никогда не ждет
+   * просеивания. При sectors равном 0 фоновый поток останавливается.
+   */
+  bool prefetch(uint32_t sectors);
 
   /**
    * @return Итератор на начало контейнера.
@@ -79,34 +267,119 @@ public:
 
   /**
    * @return Последнее проверенное на простоту число внутри функции \link
-   * PrimesCache::add_primes() \endlink.
+   * BasicPrimesCache::add_primes() \endlink.
    */
-  uint32_t last_checked() const noexcept;
+  value_type last_checked() const noexcept;
   /**
    * @return Количество найденных и запомненных простых чисел.
    */
-  uint32_t size() const noexcept;
+  value_type size() const noexcept;
+  /**
+   * @return Текущие значения счетчиков.
+   *
+   * Каждый поток считает попадания в собственном счетчике без атомарного
+   * сложения, а попадания всех потоков суммируются только здесь.
+   */
+  PrimesCacheStats stats() const;
 
 private:
-  std::vector<uint32_t> data_;
-  uint32_t last_checked_;
+  /**
+   * @brief Счетчик попаданий одного потока, занимающий отдельную строку
+   * кэша. Изменяется только своим потоком.
+   */
+  struct alignas(64) HitCounter {
+    std::atomic<uint64_t> value{0};
+    std::thread::id thread{};
+  };
+
+  void grow();
+  void hit() const noexcept;
+  std::atomic<uint64_t> *hit_counter() const noexcept;
+  void reserve(value_type max_value);
+  void request(value_type pos);
+  void prefetch_loop();
+  value_type search(value_type pos) const;
+
+  Storage data_;
+  std::vector<uint32_t> base_;
+  value_type last_checked_;
+  WheelSieve sieve_;
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::thread prefetcher_;
+  std::atomic<uint64_t> refill_at_;
+  uint64_t demand_;
+  uint32_t ahead_;
+  mutable std::deque<HitCounter> hits_;
+  uint64_t id_;
+  uint64_t misses_;
+  mutable uint64_t transient_;
+  uint64_t sectors_;
+  uint64_t sieve_ns_;
+  uint64_t grows_;
 };
 
+/**
+ * @brief Кэш простых чисел, хранящий их в \link ChunkedStorage \endlink.
+ */
+using PrimesCache = BasicPrimesCache<ChunkedStorage>;
+/**
+ * @brief Кэш простых чисел, хранящий разности между ними в \link GapStorage
+ * \endlink.
+ */
+using CompactPrimesCache = BasicPrimesCache<GapStorage>;
+/**
+ * @brief Кэш простых чисел до UINT64_MAX, хранящий их в \link
+ * BasicChunkedStorage \endlink.
+ */
+using PrimesCache64 = BasicPrimesCache<BasicChunkedStorage<uint64_t>>;
+/**
+ * @brief Кэш простых чисел до UINT64_MAX, хранящий разности между ними в
+ * \link BasicGapStorage \endlink.
+ */
+using CompactPrimesCache64 = BasicPrimesCache<BasicGapStorage<uint64_t>>;
+/**
+ * @brief Кэш простых чисел, хранящий их в \link MappedStorage \endlink.
+ */
+using MappedPrimesCache = BasicPrimesCache<MappedStorage>;
+/**
+ * @brief Кэш простых чисел до UINT64_MAX, хранящий их в \link
+ * BasicMappedStorage \endlink.
+ */
+using MappedPrimesCache64 = BasicPrimesCache<BasicMappedStorage<uint64_t>>;
+/**
+ * @brief Кэш простых чисел, доступный для чтения из нескольких потоков.
+ * Совпадает с \link PrimesCache \endlink.
+ */
+using ConcurrentPrimesCache = PrimesCache;
+/**
+ * @brief Кэш простых чисел до UINT64_MAX, доступный для чтения из нескольких
+ * потоков. Совпадает с \link PrimesCache64 \endlink.
+ */
+using ConcurrentPrimesCache64 = PrimesCache64;
+
 /**
  * @brief Класс для вычисления и хранения простых чисел.
  *
- * Оптимизирован по памяти, позволяет ограничить доступ к поиску больших чисел
+ * Оптимизирован по памяти, позволяет ограничить доступ к поиску больших чисел.
+ * Cache - тип общего для всех объектов кэша простых чисел. Общий кэш
+ * создается при первом обращении, а не до main.
  */
-class Primes {
+template <typename Cache> class BasicPrimes {
 public:
+  /**
+   * @brief Тип простых чисел.
+   */
+  using value_type = typename Cache::value_type;
+
   /**
    * @brief Конструктор контейнера без верхней границы.
    */
-  Primes();
+  BasicPrimes();
   /**
    * @brief Конструктор контейнера с верхней границей.
    */
-  Primes(uint32_t max_value);
+  BasicPrimes(value_type max_value);
 
   /**
    * В случае если простых чисел в уже сгенерированном массиве данных
@@ -114,7 +387,7 @@ public:
    * @param pos
    * @return Простое число на позии pos в случае успеха, иначе 0.
    */
-  uint32_t operator[](uint32_t pos);
+  value_type operator[](value_type pos);
   /**
    * В случае если простых чисел в уже сгенерированном массиве данных
    * недостаточно ищет новые не выделяя при этом дополнительной памяти. После
@@ -122,37 +395,77 @@ public:
    * @param pos
    * @return Простое число на позии pos в случае успеха, иначе 0.
    */
-  uint32_t operator()(uint32_t pos) const noexcept;
+  value_type operator()(value_type pos) const noexcept;
+  /**
+   * @brief Копирует простые числа на позициях [pos, pos + count) в out.
+   * @param pos
+   * @param count
+   * @param out
+   * @return Количество скопированных чисел: для контейнера с верхней границей
+   * не больше \link BasicPrimes::size() \endlink - pos.
+   *
+   * В отличие от поэлементного обращения проверяет границы и дополняет кэш
+   * один раз на весь диапазон.
+   */
+  size_t fetch(value_type pos, size_t count, value_type *out);
 
   /**
    * @return В случае контейнера с верхней границей - количество простых чисел
    * не превыщающих заданный параметр, иначе число уже найденных простых чисел.
    */
-  uint32_t size() const noexcept;
+  value_type size() const noexcept;
 
   /**
-   * @brief Класс-итератор для \link Primes \endlink.
+   * @brief Сохраняет общий кэш в файл.
+   * @param path
+   * @return Результат \link BasicPrimesCache::save() \endlink.
+   */
+  static bool save(const char *path);
+  /**
+   * @brief Загружает общий кэш из файла.
+   * @param path
+   * @return Результат \link BasicPrimesCache::load() \endlink.
+   *
+   * Должна вызываться до создания объектов с верхней границей.
+   */
+  static bool load(const char *path);
+  /**
+   * @brief Включает фоновый поиск для общего кэша.
+   * @param sectors
+   * @return Результат \link BasicPrimesCache::prefetch() \endlink.
+   */
+  static bool prefetch(uint32_t sectors);
+  /**
+   * @return Счетчики общего кэша.
+   */
+  static PrimesCacheStats stats();
+
+  /**
+   * @brief Класс-итератор для \link BasicPrimes \endlink.
    */
   class Iterator {
   public:
     /**
-     * @brief Тип разницы между итераторами для \link Primes \endlink.
+     * @brief Тип разницы между итераторами для \link BasicPrimes \endlink.
      */
-    using difference_type = int32_t;
+    using difference_type =
+        typename std::make_signed<typename BasicPrimes::value_type>::type;
     /**
-     * @brief Тип значения по итератору для \link Primes \endlink.
+     * @brief Тип значения по итератору для \link BasicPrimes \endlink.
      */
-    using value_type = uint32_t;
+    using value_type = typename BasicPrimes::value_type;
     /**
-     * @brief Тип указателя на значение по итератору для \link Primes \endlink.
+     * @brief Тип указателя на значение по итератору для \link BasicPrimes
+     * \endlink.
      */
-    using pointer = const uint32_t *;
+    using pointer = const value_type *;
     /**
-     * @brief Тип ссылки на значение по итератору для \link Primes \endlink.
+     * @brief Тип ссылки на значение по итератору для \link BasicPrimes
+     * \endlink.
      */
-    using reference = const uint32_t &;
+    using reference = const value_type &;
     /**
-     * @brief Вид итератора для \link Primes \endlink.
+     * @brief Вид итератора для \link BasicPrimes \endlink.
      */
     using iterator_category = std::random_access_iterator_tag;
 
@@ -166,7 +479,7 @@ public:
      * является end для контейнера без верхней границы end_it должен быть
      * установлен как true.
      */
-    explicit Iterator(Primes *owner, uint32_t pos = 0,
+    explicit Iterator(BasicPrimes *owner, value_type pos = 0,
                       bool end_it = false) noexcept;
 
     /**
@@ -188,14 +501,18 @@ public:
      * @return Итератор на позицию it.pos + diff.
      */
     friend Iterator operator+(Iterator const &it,
-                              difference_type diff) noexcept;
+                              difference_type diff) noexcept {
+      return Iterator(it) += diff;
+    }
     /**
      * @param diff
      * @param it
      * @return Итератор на позицию it.pos + diff.
      */
     friend Iterator operator+(difference_type diff,
-                              Iterator const &it) noexcept;
+                              Iterator const &it) noexcept {
+      return it + diff;
+    }
     /**
      * @param diff
      * @return Итератор на позицию pos - diff.
@@ -213,14 +530,18 @@ public:
      * @return Итератор на позицию it.pos - diff.
      */
     friend Iterator operator-(Iterator const &it,
-                              difference_type diff) noexcept;
+                              difference_type diff) noexcept {
+      return Iterator(it) -= diff;
+    }
     /**
      * @param lhs
      * @param rhs
      * @return Разницу между позициями на которые указывают итераторы.
      */
     friend difference_type operator-(Iterator const &lhs,
-                                     Iterator const &rhs) noexcept;
+                                     Iterator const &rhs) noexcept {
+      return lhs.distance(rhs);
+    }
 
     /**
      * @param lhs
@@ -228,71 +549,70 @@ public:
      * @return true если позиции на которые указывают итераторы равны, false -
      * иначе.
      */
-    friend bool operator==(Iterator const &lhs, Iterator const &rhs) noexcept;
+    friend bool operator==(Iterator const &lhs, Iterator const &rhs) noexcept {
+      return (lhs.end_it_ || rhs.end_it_) ? (lhs.end_it_ && rhs.end_it_)
+                                          : lhs.pos_ == rhs.pos_;
+    }
     /**
      * @param lhs
      * @param rhs
      * @return false если позиции на которые указывают итераторы равны, true -
      * иначе.
      */
-    friend bool operator!=(Iterator const &lhs, Iterator const &rhs) noexcept;
+    friend bool operator!=(Iterator const &lhs, Iterator const &rhs) noexcept {
+      return !(lhs == rhs);
+    }
     /**
      * @param lhs
      * @param rhs
      * @return true если позиция на которую указывает lhs меньше позиции на
      * которую указывает rhs, false - иначе.
      */
-    friend bool operator<(Iterator const &lhs, Iterator const &rhs) noexcept;
+    friend bool operator<(Iterator const &lhs, Iterator const &rhs) noexcept {
+      return lhs.less(rhs);
+    }
     /**
      * @param lhs
      * @param rhs
      * @return true если позиция на которую указывает lhs больше позиции на
      * которую указывает rhs, false - иначе.
      */
-    friend bool operator>(Iterator const &lhs, Iterator const &rhs) noexcept;
+    friend bool operator>(Iterator const &lhs, Iterator const &rhs) noexcept {
+      return rhs < lhs;
+    }
     /**
      * @param lhs
      * @param rhs
      * @return true если позиция на которую указывает lhs не меньше позиции на
      * которую указывает rhs, false - иначе.
      */
-    friend bool operator>=(Iterator const &lhs, Iterator const &rhs) noexcept;
+    friend bool operator>=(Iterator const &lhs, Iterator const &rhs) noexcept {
+      return !(lhs < rhs);
+    }
     /**
      * @param lhs
      * @param rhs
      * @return true если позиция на которую указывает lhs не больше позиции на
      * которую указывает rhs, false - иначе.
      */
-    friend bool operator<=(Iterator const &lhs, Iterator const &rhs) noexcept;
+    friend bool operator<=(Iterator const &lhs, Iterator const &rhs) noexcept {
+      return !(lhs > rhs);
+    }
 
     /**
      * @return Значение на позиции, на которую указывает итератор, в случае
      * успеха, иначе 0.
      */
-    uint32_t operator*() const;
+    value_type operator*() const;
 
   private:
-    Primes *owner_;
-    uint32_t pos_;
+    difference_type distance(Iterator const &rhs) const noexcept;
+    bool less(Iterator const &rhs) const noexcept;
+
+    BasicPrimes *owner_;
+    value_type pos_;
     bool end_it_;
   };
-  friend Iterator operator+(Iterator const &it,
-                            Iterator::difference_type diff) noexcept;
-  friend Iterator operator+(Iterator::difference_type diff,
-                            Iterator const &it) noexcept;
-  friend Iterator operator-(Iterator const &it,
-                            Iterator::difference_type diff) noexcept;
-
-  friend Iterator::difference_type operator-(Iterator const &lhs,
-                                             Iterator const &rhs) noexcept;
-
-  friend bool operator==(Iterator const &lhs, Iterator const &rhs) noexcept;
-  friend bool operator!=(Iterator const &lhs, Iterator const &rhs) noexcept;
-
-  friend bool operator<(Iterator const &lhs, Iterator const &rhs) noexcept;
-  friend bool operator>(Iterator const &lhs, Iterator const &rhs) noexcept;
-  friend bool operator>=(Iterator const &lhs, Iterator const &rhs) noexcept;
-  friend bool operator<=(Iterator const &lhs, Iterator const &rhs) noexcept;
 
   /**
    * @return  Итератор на начало контейнера.
@@ -304,9 +624,47 @@ public:
   Iterator end();
 
 private:
-  static PrimesCache data_;
-  uint32_t size_;
+  static Cache &cache();
+
+  value_type size_;
   bool unbound_;
 };
 
+/**
+ * @brief Простые числа из общего \link PrimesCache \endlink.
+ */
+using Primes = BasicPrimes<PrimesCache>;
+/**
+ * @brief Простые числа из общего \link CompactPrimesCache \endlink.
+ */
+using CompactPrimes = BasicPrimes<CompactPrimesCache>;
+/**
+ * @brief Простые числа до UINT64_MAX из общего \link PrimesCache64 \endlink.
+ */
+using Primes64 = BasicPrimes<PrimesCache64>;
+/**
+ * @brief Простые числа до UINT64_MAX из общего \link CompactPrimesCache64
+ * \endlink.
+ */
+using CompactPrimes64 = BasicPrimes<CompactPrimesCache64>;
+/**
+ * @brief Простые числа из общего \link MappedPrimesCache \endlink.
+ */
+using MappedPrimes = BasicPrimes<MappedPrimesCache>;
+/**
+ * @brief Простые числа до UINT64_MAX из общего \link MappedPrimesCache64
+ * \endlink.
+ */
+using MappedPrimes64 = BasicPrimes<MappedPrimesCache64>;
+/**
+ * @brief Простые числа из общего \link ConcurrentPrimesCache \endlink,
+ * объекты которых можно использовать из разных потоков.
+ */
+using ConcurrentPrimes = BasicPrimes<ConcurrentPrimesCache>;
+/**
+ * @brief Простые числа до UINT64_MAX из общего \link ConcurrentPrimesCache64
+ * \endlink, объекты которых можно использовать из разных потоков.
+ */
+using ConcurrentPrimes64 = BasicPrimes<ConcurrentPrimesCache64>;
+
 #endif // PRIMES_H
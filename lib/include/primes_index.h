@@ -0,0 +1,118 @@
+#ifndef PRIMES_INDEX_H
+#define PRIMES_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+/**
+ * @brief Шаг по номеру простого числа между контрольными точками \link
+ * BasicPrimesIndex \endlink по умолчанию.
+ */
+const uint32_t INDEX_STEP{65536};
+/**
+ * @brief Версия формата файла, создаваемого \link BasicPrimesIndex::save()
+ * \endlink.
+ */
+const uint32_t INDEX_FILE_VERSION{1};
+} // namespace
+
+/**
+ * @brief Разреженный индекс простых чисел до заданной границы.
+ *
+ * Хранит только каждое step-е простое число (контрольные точки), поэтому для
+ * UINT32_MAX и шага \link INDEX_STEP \endlink контрольные точки занимают
+ * около 12 КБ вместо 800 МБ массива всех чисел. Обращение к n-му простому
+ * числу или подсчет pi(v) просеивают только отрезок между двумя соседними
+ * контрольными точками длиной около step * ln(v) чисел. Индекс строится
+ * одним проходом решета или загружается из файла \link
+ * BasicPrimesIndex::save() \endlink.
+ */
+template <typename T> class BasicPrimesIndex {
+public:
+  /**
+   * @brief Тип простых чисел.
+   */
+  using value_type = T;
+
+  /**
+   * @brief Конструктор пустого индекса, который можно заполнить \link
+   * BasicPrimesIndex::load() \endlink.
+   */
+  BasicPrimesIndex() noexcept;
+  /**
+   * @brief Конструктор.
+   * @param max_value
+   * @param step
+   *
+   * Просеивает [0, max_value] и запоминает простые числа на позициях,
+   * кратных step.
+   */
+  explicit BasicPrimesIndex(T max_value, uint32_t step = INDEX_STEP);
+
+  /**
+   * @param pos
+   * @return Простое число на позиции pos в случае успеха, иначе 0.
+   */
+  T operator[](T pos) const;
+  /**
+   * @param value
+   * @return Количество простых чисел, не превышающих min(value, \link
+   * BasicPrimesIndex::max_value() \endlink).
+   */
+  T count(T value) const;
+
+  /**
+   * @return Количество простых чисел, не превышающих \link
+   * BasicPrimesIndex::max_value() \endlink.
+   */
+  T size() const noexcept;
+  /**
+   * @return Верхняя граница индекса.
+   */
+  T max_value() const noexcept;
+  /**
+   * @return Шаг по номеру между контрольными точками.
+   */
+  uint32_t step() const noexcept;
+  /**
+   * @return Объем памяти контрольных точек и простых чисел для просеивания в
+   * байтах.
+   */
+  size_t memory() const noexcept;
+
+  /**
+   * @brief Сохраняет индекс в файл.
+   * @param path
+   * @return true в случае успеха, false - иначе.
+   */
+  bool save(const char *path) const;
+  /**
+   * @brief Заменяет индекс загруженным из файла.
+   * @param path
+   * @return true в случае успеха, false - иначе (индекс не меняется, если
+   * файл отсутствует, поврежден или записан для другого типа T).
+   */
+  bool load(const char *path);
+
+private:
+  template <typename F> void sieve(uint64_t lo, uint64_t hi, F f) const;
+
+  std::vector<T> checkpoints_;
+  std::vector<uint32_t> base_;
+  T max_value_;
+  T size_;
+  uint32_t step_;
+};
+
+/**
+ * @brief Индекс простых чисел до UINT32_MAX.
+ */
+using PrimesIndex = BasicPrimesIndex<uint32_t>;
+/**
+ * @brief Индекс простых чисел до UINT64_MAX.
+ */
+using PrimesIndex64 = BasicPrimesIndex<uint64_t>;
+
+#endif // PRIMES_INDEX_H
@@ -0,0 +1,80 @@
+#ifndef PRIMES_RANGE_H
+#define PRIMES_RANGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Класс для вычисления простых чисел на отрезке [lo, hi].
+ *
+ * В отличие от \link BasicPrimes \endlink не использует общий кэш и не
+ * вычисляет простые числа меньше lo: просеивается только заданный отрезок с
+ * помощью простых чисел до sqrt(hi), поэтому используемая память
+ * пропорциональна длине отрезка.
+ */
+template <typename T> class BasicPrimesRange {
+public:
+  /**
+   * @brief Тип простых чисел.
+   */
+  using value_type = T;
+  /**
+   * @brief Тип итератора для \link BasicPrimesRange \endlink.
+   */
+  using const_iterator = typename std::vector<T>::const_iterator;
+
+  /**
+   * @brief Конструктор.
+   * @param lo
+   * @param hi
+   *
+   * Находит все простые числа p, для которых lo <= p <= hi.
+   */
+  BasicPrimesRange(T lo, T hi);
+
+  /**
+   * @param pos
+   * @return Простое число на позиции pos внутри отрезка в случае успеха,
+   * иначе 0.
+   */
+  T operator[](T pos) const noexcept;
+
+  /**
+   * @return Итератор на начало контейнера.
+   */
+  const_iterator begin() const noexcept;
+  /**
+   * @return Итератор на конец контейнера.
+   */
+  const_iterator end() const noexcept;
+
+  /**
+   * @return Количество простых чисел на отрезке.
+   */
+  T size() const noexcept;
+  /**
+   * @return Нижняя граница отрезка.
+   */
+  T low() const noexcept;
+  /**
+   * @return Верхняя граница отрезка.
+   */
+  T high() const noexcept;
+
+private:
+  std::vector<T> data_;
+  T low_;
+  T high_;
+};
+
+/**
+ * @brief Простые числа на отрезке внутри [0, UINT32_MAX].
+ */
+using PrimesRange = BasicPrimesRange<uint32_t>;
+/**
+ * @brief Простые числа на отрезке внутри [0, UINT64_MAX].
+ */
+using PrimesRange64 = BasicPrimesRange<uint64_t>;
+
+#endif // PRIMES_RANGE_H
@@ -0,0 +1,182 @@
+#ifndef PRIMES_STREAM_H
+#define PRIMES_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "wheel_sieve.h"
+
+namespace {
+/**
+ * @brief Ограничение памяти окна \link BasicPrimesStream \endlink по
+ * умолчанию в байтах.
+ */
+const size_t STREAM_BUDGET{size_t(1) << 24};
+} // namespace
+
+/**
+ * @brief Класс для последовательного перебора простых чисел без верхней
+ * границы в ограниченной памяти.
+ *
+ * В отличие от \link BasicPrimes \endlink не использует общий кэш и хранит
+ * только окно последних найденных чисел и простые числа для просеивания от
+ * SMALL_PRIMES_LIMIT до корня из максимального значения T (меньшие берутся
+ * прямо из \link SMALL_PRIMES \endlink). Когда окно превышает заданный
+ * объем памяти, самые старые числа вытесняются, поэтому обращаться можно
+ * только к позициям не меньше \link BasicPrimesStream::first() \endlink.
+ * Новые числа ищутся по секторам \link SECTOR_SIZE \endlink, поэтому окно
+ * может превысить ограничение на один сектор.
+ */
+template <typename T> class BasicPrimesStream {
+public:
+  /**
+   * @brief Тип простых чисел.
+   */
+  using value_type = T;
+
+  /**
+   * @brief Конструктор.
+   * @param budget Ограничение памяти окна в байтах.
+   */
+  explicit BasicPrimesStream(size_t budget = STREAM_BUDGET);
+
+  /**
+   * В случае если найденных простых чисел недостаточно ищет новые, вытесняя
+   * из окна числа на позициях меньше pos.
+   * @param pos
+   * @return Простое число на позиции pos в случае успеха, иначе 0 (число
+   * вытеснено или выходит за границы T).
+   */
+  T operator[](T pos);
+
+  /**
+   * @return Позиция самого старого простого числа в окне.
+   */
+  T first() const noexcept;
+  /**
+   * @return Количество найденных простых чисел, включая вытесненные.
+   */
+  T size() const noexcept;
+  /**
+   * @return Объем памяти, занимаемой окном, простыми числами для просеивания
+   * и буфером решета, в байтах.
+   */
+  size_t memory() const noexcept;
+
+  /**
+   * @brief Однонаправленный итератор для \link BasicPrimesStream \endlink.
+   *
+   * Разыменование может вытеснить числа перед текущей позицией, поэтому
+   * после продвижения итератора предыдущие позиции могут стать недоступны.
+   */
+  class Iterator {
+  public:
+    /**
+     * @brief Тип разницы между итераторами.
+     */
+    using difference_type = typename std::make_signed<T>::type;
+    /**
+     * @brief Тип значения по итератору.
+     */
+    using value_type = T;
+    /**
+     * @brief Тип указателя на значение по итератору.
+     */
+    using pointer = const value_type *;
+    /**
+     * @brief Тип ссылки на значение по итератору.
+     */
+    using reference = value_type;
+    /**
+     * @brief Вид итератора.
+     */
+    using iterator_category = std::input_iterator_tag;
+
+    /**
+     * @brief Конструктор.
+     * @param owner
+     * @param pos
+     * @param end_it true для итератора на конец контейнера.
+     */
+    Iterator(BasicPrimesStream *owner, T pos, bool end_it) noexcept;
+
+    /**
+     * @return Итератор на позицию pos + 1.
+     */
+    Iterator &operator++() noexcept;
+    /**
+     * @return Итератор на позицию pos.
+     */
+    Iterator operator++(int) noexcept;
+
+    /**
+     * @param lhs
+     * @param rhs
+     * @return true если оба итератора указывают на одну позицию или
+     * обозначают конец контейнера, false - иначе. Итератор на позицию за
+     * последним простым числом T равен концу контейнера.
+     */
+    friend bool operator==(Iterator const &lhs, Iterator const &rhs) {
+      if (lhs.end_it_ || rhs.end_it_) {
+        return lhs.exhausted() && rhs.exhausted();
+      }
+      return lhs.pos_ == rhs.pos_;
+    }
+    /**
+     * @param lhs
+     * @param rhs
+     * @return Отрицание lhs == rhs.
+     */
+    friend bool operator!=(Iterator const &lhs, Iterator const &rhs) {
+      return !(lhs == rhs);
+    }
+
+    /**
+     * @return Значение на позиции, на которую указывает итератор, в случае
+     * успеха, иначе 0.
+     */
+    value_type operator*() const;
+
+  private:
+    bool exhausted() const;
+
+    BasicPrimesStream *owner_;
+    T pos_;
+    bool end_it_;
+  };
+
+  /**
+   * @return Итератор на позицию \link BasicPrimesStream::first() \endlink.
+   */
+  Iterator begin() noexcept;
+  /**
+   * @return Итератор на конец контейнера.
+   */
+  Iterator end() noexcept;
+
+private:
+  bool grow();
+
+  std::deque<T> window_;
+  std::vector<uint32_t> base_;
+  WheelSieve sieve_;
+  size_t limit_;
+  T first_;
+  uint64_t next_;
+  bool done_;
+};
+
+/**
+ * @brief Простые числа до UINT32_MAX в ограниченной памяти.
+ */
+using PrimesStream = BasicPrimesStream<uint32_t>;
+/**
+ * @brief Простые числа до UINT64_MAX в ограниченной памяти.
+ */
+using PrimesStream64 = BasicPrimesStream<uint64_t>;
+
+#endif // PRIMES_STREAM_H
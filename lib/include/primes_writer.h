@@ -0,0 +1,92 @@
+#ifndef PRIMES_WRITER_H
+#define PRIMES_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+/**
+ * @brief Размер буфера \link PrimesWriter \endlink в байтах.
+ */
+const size_t WRITER_BUFFER{1 << 20};
+/**
+ * @brief Максимальная длина десятичной записи 64-битного числа.
+ */
+const size_t DECIMAL_DIGITS{20};
+} // namespace
+
+/**
+ * @brief Записывает десятичное представление value начиная с out.
+ * @param value
+ * @param out
+ * @return Указатель на символ, следующий за последней цифрой.
+ *
+ * В out должно быть не меньше DECIMAL_DIGITS свободных символов. Цифры
+ * вычисляются парами по таблице из 200 символов.
+ */
+char *format_decimal(uint64_t value, char *out) noexcept;
+
+/**
+ * @brief Буферизованный вывод чисел в файловый дескриптор.
+ *
+ * Числа форматируются в буфер размера WRITER_BUFFER, который сбрасывается
+ * системным вызовом write при заполнении, поэтому вывод идет по мере
+ * вычисления простых чисел без промежуточного массива и без накладных
+ * расходов stdio на каждое число.
+ */
+class PrimesWriter {
+public:
+  /**
+   * @brief Конструктор.
+   * @param fd
+   * @param separator
+   *
+   * Каждое число записывается в fd с последующим символом separator.
+   * Дескриптор не закрывается.
+   */
+  explicit PrimesWriter(int fd, char separator = '\n');
+  /**
+   * @brief Деструктор, сбрасывающий буфер.
+   */
+  ~PrimesWriter();
+
+  PrimesWriter(PrimesWriter const &) = delete;
+  PrimesWriter &operator=(PrimesWriter const &) = delete;
+
+  /**
+   * @brief Добавляет value в буфер.
+   * @param value
+   */
+  void write(uint64_t value);
+
+  /**
+   * @brief Записывает содержимое буфера в дескриптор.
+   * @return true в случае успеха, false - если запись не удалась.
+   */
+  bool flush();
+
+  /**
+   * @return Количество записанных чисел.
+   */
+  uint64_t count() const noexcept;
+
+private:
+  std::vector<char> buffer_;
+  size_t used_;
+  uint64_t count_;
+  int fd_;
+  char separator_;
+};
+
+inline void PrimesWriter::write(uint64_t value) {
+  if (buffer_.size() - used_ <= DECIMAL_DIGITS) {
+    flush();
+  }
+  char *end = format_decimal(value, buffer_.data() + used_);
+  *end++ = separator_;
+  used_ = static_cast<size_t>(end - buffer_.data());
+  ++count_;
+}
+
+#endif // PRIMES_WRITER_H
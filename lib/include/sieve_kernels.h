@@ -0,0 +1,48 @@
+#ifndef SIEVE_KERNELS_H
+#define SIEVE_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Набор реализаций внутренних циклов обработки битовой карты решета на
+ * колесе 30 (см. \link WheelSieve::bitmap() \endlink) для одного набора
+ * инструкций процессора.
+ */
+struct SieveKernels {
+  /**
+   * @brief Название набора инструкций: "scalar", "popcnt", "avx2" или
+   * "avx512".
+   */
+  const char *isa;
+  /**
+   * @brief Количество установленных битов в bytes байтах data.
+   */
+  uint64_t (*count)(const uint8_t *data, size_t bytes);
+  /**
+   * @brief Записывает в out числа base + WHEEL_SIZE * i + WHEEL_RESIDUES[k]
+   * для каждого установленного бита k байта i из bytes байт data в порядке
+   * возрастания и возвращает их количество. out должен вмещать 8 * bytes
+   * чисел: значения за возвращенным количеством могут быть перезаписаны.
+   */
+  size_t (*decode)(const uint8_t *data, size_t bytes, uint64_t base,
+                   uint64_t *out);
+};
+
+/**
+ * @return Лучший набор \link SieveKernels \endlink, поддерживаемый
+ * процессором, на котором запущена программа. Определяется через CPUID при
+ * первом вызове, поэтому одна сборка использует AVX-512 или AVX2 там, где они
+ * есть, и остается работоспособной на остальных процессорах.
+ */
+const SieveKernels &sieve_kernels() noexcept;
+
+/**
+ * @return Все наборы \link SieveKernels \endlink, поддерживаемые
+ * процессором, начиная со "scalar" и в порядке возрастания набора
+ * инструкций.
+ */
+std::vector<SieveKernels> supported_sieve_kernels();
+
+#endif // SIEVE_KERNELS_H
@@ -0,0 +1,71 @@
+#ifndef SMALL_PRIMES_H
+#define SMALL_PRIMES_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+/**
+ * @brief Граница таблицы \link SMALL_PRIMES \endlink: первое число, квадрат
+ * которого выходит за границы UINT32_MAX.
+ */
+constexpr uint32_t SMALL_PRIMES_LIMIT{65536};
+/**
+ * @brief Количество простых чисел меньше \link SMALL_PRIMES_LIMIT \endlink.
+ */
+constexpr size_t SMALL_PRIMES_COUNT{6542};
+} // namespace
+
+/**
+ * @brief Все простые числа меньше \link SMALL_PRIMES_LIMIT \endlink в порядке
+ * возрастания.
+ */
+struct SmallPrimes {
+  uint32_t values[SMALL_PRIMES_COUNT];
+
+  constexpr const uint32_t *begin() const noexcept { return values; }
+  constexpr const uint32_t *end() const noexcept {
+    return values + SMALL_PRIMES_COUNT;
+  }
+};
+
+/**
+ * @return Таблица \link SmallPrimes \endlink, построенная решетом
+ * Эратосфена по нечетным числам.
+ *
+ * Предназначена для вычисления при компиляции: см. \link SMALL_PRIMES
+ * \endlink.
+ */
+constexpr SmallPrimes make_small_primes() noexcept {
+  SmallPrimes result{};
+  bool composite[SMALL_PRIMES_LIMIT / 2]{};
+  for (uint32_t odd = 3; odd * odd < SMALL_PRIMES_LIMIT; odd += 2) {
+    if (composite[odd / 2]) {
+      continue;
+    }
+    for (uint32_t not_prime = odd * odd; not_prime < SMALL_PRIMES_LIMIT;
+         not_prime += 2 * odd) {
+      composite[not_prime / 2] = true;
+    }
+  }
+  size_t size = 0;
+  result.values[size++] = 2;
+  for (uint32_t odd = 3; odd < SMALL_PRIMES_LIMIT; odd += 2) {
+    if (!composite[odd / 2]) {
+      result.values[size++] = odd;
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Простые числа меньше \link SMALL_PRIMES_LIMIT \endlink, вычисленные
+ * при компиляции и размещенные в данных только для чтения. Их достаточно для
+ * просеивания любого отрезка в пределах uint32_t.
+ */
+inline constexpr SmallPrimes SMALL_PRIMES{make_small_primes()};
+
+static_assert(SMALL_PRIMES.values[SMALL_PRIMES_COUNT - 1] == 65521,
+              "SMALL_PRIMES_COUNT does not match SMALL_PRIMES_LIMIT");
+
+#endif // SMALL_PRIMES_H
@@ -0,0 +1,239 @@
+#ifndef WHEEL_SIEVE_H
+#define WHEEL_SIEVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "sieve_kernels.h"
+#include "small_primes.h"
+
+namespace {
+/**
+ * @brief Период колеса: каждый байт решета описывает WHEEL_SIZE подряд идущих
+ * чисел.
+ */
+const uint32_t WHEEL_SIZE{30};
+/**
+ * @brief Остатки по модулю WHEEL_SIZE, взаимно простые с WHEEL_SIZE. Бит k
+ * байта решета соответствует остатку WHEEL_RESIDUES[k].
+ */
+const uint8_t WHEEL_RESIDUES[8]{1, 7, 11, 13, 17, 19, 23, 29};
+/**
+ * @brief Номер бита для каждого остатка по модулю WHEEL_SIZE, 8 - если
+ * остаток не взаимно прост с WHEEL_SIZE.
+ */
+const uint8_t WHEEL_INDEX[WHEEL_SIZE]{8, 0, 8, 8, 8, 8, 8, 1, 8, 8,
+                                      8, 2, 8, 3, 8, 8, 8, 4, 8, 5,
+                                      8, 8, 8, 6, 8, 8, 8, 8, 8, 7};
+/**
+ * @brief Количество байт решета, которые \link WheelSieve::for_each_prime()
+ * \endlink за один раз раскладывает в числа перед вызовами f.
+ */
+const size_t DECODE_CHUNK{256};
+} // namespace
+
+/**
+ * @brief Сегментное решето на колесе 30.
+ *
+ * Хранит только числа, взаимно простые с 30 (8 бит на 30 чисел), и
+ * вычеркивает составные числа отдельным шагом для каждого остатка. Буфер
+ * сегмента переиспользуется между вызовами \link WheelSieve::sieve() \endlink.
+ * Подсчет и перечисление простых чисел выполняются ядрами \link
+ * sieve_kernels() \endlink для набора инструкций текущего процессора.
+ *
+ * Буфер заполняется копиями заранее просеянного периодического шаблона, в
+ * котором уже вычеркнуты кратные 7, 11, 13, 17 и 19, поэтому вычеркивание
+ * начинается с 23. Затем отрезок просеивается окнами по \link sieve_window()
+ * \endlink байт. Простые числа меньше окна вычеркивают кратные в каждом
+ * окне, большие хранятся в корзинах по номеру окна, в котором встретится их
+ * следующее кратное (Oliveira e Silva), и обрабатываются только в этом окне.
+ * Если следующий вызов продолжает предыдущий отрезок с теми же простыми
+ * числами, позиции кратных берутся из прошлого вызова без делений.
+ */
+class WheelSieve {
+public:
+  /**
+   * @brief Конструктор пустого решета.
+   */
+  WheelSieve() noexcept;
+
+  /**
+   * @brief Просеивает отрезок [lo, hi].
+   * @param lo
+   * @param hi
+   * @param primes_begin
+   * @param primes_end
+   *
+   * Диапазон [primes_begin, primes_end) должен быть отсортирован и содержать
+   * все простые числа, не превышающие sqrt(hi).
+   */
+  void sieve(uint64_t lo, uint64_t hi, const uint32_t *primes_begin,
+             const uint32_t *primes_end);
+  /**
+   * @brief Просеивает отрезок [lo, hi] простыми числами из двух диапазонов.
+   * @param lo
+   * @param hi
+   * @param primes_begin
+   * @param primes_end
+   * @param more_begin
+   * @param more_end
+   *
+   * То же, что и \link WheelSieve::sieve() \endlink для диапазона, в котором
+   * за [primes_begin, primes_end) следует [more_begin, more_end). Позволяет
+   * просеивать по \link SMALL_PRIMES \endlink и отдельно хранимым большим
+   * простым числам без копирования таблицы.
+   */
+  void sieve(uint64_t lo, uint64_t hi, const uint32_t *primes_begin,
+             const uint32_t *primes_end, const uint32_t *more_begin,
+             const uint32_t *more_end);
+
+  /**
+   * @brief Вызывает f для каждого простого числа последнего просеянного
+   * отрезка в порядке возрастания.
+   * @param f
+   */
+  template <typename F> void for_each_prime(F f) const;
+
+  /**
+   * @return Количество простых чисел последнего просеянного отрезка.
+   */
+  uint64_t count() const noexcept;
+
+  /**
+   * @return Битовая карта последнего просеянного отрезка: бит k байта i
+   * установлен, если число base + WHEEL_SIZE * i + WHEEL_RESIDUES[k] простое,
+   * где base - наибольшее кратное WHEEL_SIZE, не превышающее \link
+   * WheelSieve::low() \endlink. Числа вне отрезка и 2, 3, 5 в ней не
+   * отмечены.
+   */
+  const std::vector<uint8_t> &bitmap() const noexcept;
+
+  /**
+   * @return Нижняя граница последнего просеянного отрезка.
+   */
+  uint64_t low() const noexcept;
+  /**
+   * @return Верхняя граница последнего просеянного отрезка.
+   */
+  uint64_t high() const noexcept;
+
+private:
+  /**
+   * @brief Следующее кратное простого числа с фиксированным остатком
+   * множителя по модулю WHEEL_SIZE: кратные отстоят друг от друга на prime
+   * байт решета и всегда попадают в бит bit.
+   */
+  struct Multiple {
+    uint64_t next;
+    uint32_t prime;
+    uint8_t bit;
+  };
+
+  void reset() noexcept;
+  void add_primes(const uint32_t *primes_begin, const uint32_t *primes_end);
+  void resize_buckets(size_t count);
+  void cross_window(uint64_t first, uint64_t last, uint64_t stop);
+
+  std::vector<uint8_t> data_;
+  uint64_t base_;
+  uint64_t low_;
+  uint64_t high_;
+  std::vector<Multiple> small_;
+  std::vector<std::vector<Multiple>> buckets_;
+  std::vector<Multiple> spare_;
+  size_t active_;
+  uint32_t last_prime_;
+};
+
+/**
+ * @return Размер окна \link WheelSieve \endlink в байтах: размер кэша данных
+ * первого уровня, определенный при первом вызове.
+ */
+size_t sieve_window() noexcept;
+
+/**
+ * @return Длина отрезка, просеиваемого за один вызов \link
+ * WheelSieve::sieve() \endlink в \link for_each_segment() \endlink и
+ * \link primes_up_to() \endlink: буфер решета занимает половину кэша
+ * второго уровня, определенного при первом вызове.
+ */
+uint64_t segment_size() noexcept;
+
+/**
+ * @param value
+ * @return Целая часть квадратного корня из value.
+ */
+uint32_t integer_sqrt(uint64_t value) noexcept;
+
+/**
+ * @param limit
+ * @return Все простые числа, не превышающие limit, в порядке возрастания.
+ *
+ * Числа меньше \link SMALL_PRIMES_LIMIT \endlink копируются из \link
+ * SMALL_PRIMES \endlink, остальные просеиваются по ней.
+ */
+std::vector<uint32_t> primes_up_to(uint32_t limit);
+
+/**
+ * @brief Просеивает отрезок [lo, hi] частями по \link segment_size() \endlink
+ * и передает каждую просеянную часть в f.
+ * @param lo
+ * @param hi
+ * @param f
+ *
+ * f вызывается с const WheelSieve & в порядке возрастания отрезков и может
+ * использовать \link WheelSieve::for_each_prime() \endlink, \link
+ * WheelSieve::count() \endlink или \link WheelSieve::bitmap() \endlink.
+ * После возврата из f буфер решета переиспользуется, поэтому используемая
+ * память не зависит от длины отрезка.
+ */
+template <typename F> void for_each_segment(uint64_t lo, uint64_t hi, F f);
+
+template <typename F> void WheelSieve::for_each_prime(F f) const {
+  if (low_ > high_) {
+    return;
+  }
+  for (uint64_t small : {UINT64_C(2), UINT64_C(3), UINT64_C(5)}) {
+    if (low_ <= small && small <= high_) {
+      f(small);
+    }
+  }
+  SieveKernels const &kernels = sieve_kernels();
+  uint64_t values[8 * DECODE_CHUNK];
+  for (size_t i = 0; i < data_.size(); i += DECODE_CHUNK) {
+    size_t bytes = data_.size() - i < DECODE_CHUNK ? data_.size() - i
+                                                   : DECODE_CHUNK;
+    size_t size = kernels.decode(data_.data() + i, bytes,
+                                 base_ + i * WHEEL_SIZE, values);
+    for (size_t k = 0; k < size; ++k) {
+      f(values[k]);
+    }
+  }
+}
+
+template <typename F> void for_each_segment(uint64_t lo, uint64_t hi, F f) {
+  if (lo > hi) {
+    return;
+  }
+  std::vector<uint32_t> base;
+  const uint32_t *base_begin = SMALL_PRIMES.begin();
+  const uint32_t *base_end = SMALL_PRIMES.end();
+  if (integer_sqrt(hi) >= SMALL_PRIMES_LIMIT) {
+    base = primes_up_to(integer_sqrt(hi));
+    base_begin = base.data();
+    base_end = base.data() + base.size();
+  }
+  WheelSieve sieve;
+  const uint64_t size = segment_size();
+  for (uint64_t first = lo;; first += size) {
+    uint64_t last = hi - first < size ? hi : first + size - 1;
+    sieve.sieve(first, last, base_begin, base_end);
+    f(static_cast<WheelSieve const &>(sieve));
+    if (last == hi) {
+      break;
+    }
+  }
+}
+
+#endif // WHEEL_SIEVE_H
@@ -0,0 +1,147 @@
+#include "../include/chunked_storage.h"
+
+#include <cstring>
+#include <new>
+
+#include <sys/mman.h>
+
+namespace {
+/**
+ * @brief Размер большой страницы, по которому выравниваются области памяти.
+ */
+const size_t HUGE_PAGE{2097152};
+} // namespace
+
+template <typename T>
+BasicChunkedStorage<T>::BasicChunkedStorage() noexcept
+    : directory_{}, size_{0}, chunks_{0}, regions_{}, arena_begin_{nullptr},
+      arena_end_{nullptr} {}
+
+template <typename T> BasicChunkedStorage<T>::~BasicChunkedStorage() {
+  for (std::pair<void *, size_t> const &region : regions_) {
+    munmap(region.first, region.second);
+  }
+}
+
+template <typename T> void BasicChunkedStorage<T>::map_arena(size_t chunks) {
+  size_t bytes = chunks * CHUNK_SIZE * sizeof(T);
+  bytes = (bytes + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE;
+  void *map = mmap(nullptr, bytes + HUGE_PAGE, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  uintptr_t address = reinterpret_cast<uintptr_t>(map);
+  uintptr_t aligned = (address + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE;
+  if (aligned != address) {
+    munmap(map, aligned - address);
+  }
+  munmap(reinterpret_cast<void *>(aligned + bytes),
+         address + HUGE_PAGE - aligned);
+#ifdef MADV_HUGEPAGE
+  madvise(reinterpret_cast<void *>(aligned), bytes, MADV_HUGEPAGE);
+#endif
+  regions_.emplace_back(reinterpret_cast<void *>(aligned), bytes);
+  arena_begin_ = reinterpret_cast<T *>(aligned);
+  arena_end_ = arena_begin_ + bytes / sizeof(T);
+}
+
+template <typename T> void BasicChunkedStorage<T>::add_chunk() {
+  std::unique_ptr<T *[]> &page = directory_[chunks_ / CHUNK_DIRECTORY];
+  if (!page) {
+    page.reset(new T *[CHUNK_DIRECTORY]());
+  }
+  if (static_cast<size_t>(arena_end_ - arena_begin_) < CHUNK_SIZE) {
+    map_arena(CHUNK_ARENA);
+  }
+  page[chunks_ % CHUNK_DIRECTORY] = arena_begin_;
+  arena_begin_ += CHUNK_SIZE;
+  ++chunks_;
+}
+
+template <typename T> void BasicChunkedStorage<T>::push_back(T value) {
+  size_t pos = size_.load(std::memory_order_relaxed);
+  size_t chunk = pos / CHUNK_SIZE;
+  if (chunk == chunks_) {
+    add_chunk();
+  }
+  directory_[chunk / CHUNK_DIRECTORY][chunk % CHUNK_DIRECTORY]
+            [pos % CHUNK_SIZE] = value;
+  size_.store(pos + 1, std::memory_order_release);
+}
+
+template <typename T> void BasicChunkedStorage<T>::reserve(size_t count) {
+  size_t needed = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  size_t free = static_cast<size_t>(arena_end_ - arena_begin_) / CHUNK_SIZE;
+  if (needed <= chunks_ + free) {
+    return;
+  }
+  while (free--) {
+    add_chunk();
+  }
+  map_arena(needed - chunks_);
+}
+
+template <typename T>
+void BasicChunkedStorage<T>::copy(size_t pos, size_t count,
+                                  T *out) const noexcept {
+  while (count) {
+    size_t chunk = pos / CHUNK_SIZE;
+    size_t part = CHUNK_SIZE - pos % CHUNK_SIZE;
+    if (part > count) {
+      part = count;
+    }
+    std::memcpy(out,
+                directory_[chunk / CHUNK_DIRECTORY][chunk % CHUNK_DIRECTORY] +
+                    pos % CHUNK_SIZE,
+                part * sizeof(T));
+    pos += part;
+    out += part;
+    count -= part;
+  }
+}
+
+template <typename T> T BasicChunkedStorage<T>::back() const noexcept {
+  return (*this)[size() - 1];
+}
+
+template <typename T> size_t BasicChunkedStorage<T>::size() const noexcept {
+  return size_.load(std::memory_order_acquire);
+}
+
+template <typename T>
+size_t BasicChunkedStorage<T>::capacity() const noexcept {
+  return chunks_ * CHUNK_SIZE +
+         static_cast<size_t>(arena_end_ - arena_begin_);
+}
+
+template <typename T>
+size_t BasicChunkedStorage<T>::memory() const noexcept {
+  size_t result = 0;
+  for (std::pair<void *, size_t> const &region : regions_) {
+    result += region.second;
+  }
+  for (std::unique_ptr<T *[]> const &page : directory_) {
+    result += page ? CHUNK_DIRECTORY * sizeof(T *) : 0;
+  }
+  return result;
+}
+
+template <typename T> bool BasicChunkedStorage<T>::empty() const noexcept {
+  return size() == 0;
+}
+
+template <typename T>
+typename BasicChunkedStorage<T>::const_iterator
+BasicChunkedStorage<T>::begin() const noexcept {
+  return const_iterator(this, 0);
+}
+
+template <typename T>
+typename BasicChunkedStorage<T>::const_iterator
+BasicChunkedStorage<T>::end() const noexcept {
+  return const_iterator(this, size());
+}
+
+template class BasicChunkedStorage<uint32_t>;
+template class BasicChunkedStorage<uint64_t>;
@@ -0,0 +1,169 @@
+#include "../include/gap_storage.h"
+
+namespace {
+/**
+ * @brief Значение байта, после которого половина разности записана в двух
+ * следующих байтах.
+ */
+const uint8_t GAP_ESCAPE{255};
+} // namespace
+
+template <typename T>
+BasicGapStorage<T>::BasicGapStorage() noexcept
+    : gaps_{}, samples_{}, offsets_{}, size_{0}, back_{0} {}
+
+template <typename T> void BasicGapStorage<T>::push_back(T value) {
+  if (size_ % GAP_SAMPLE == 0) {
+    samples_.push_back(value);
+    offsets_.push_back(gaps_.size());
+  } else {
+    T half = (value - back_) / 2;
+    if (half < GAP_ESCAPE) {
+      gaps_.push_back(static_cast<uint8_t>(half));
+    } else {
+      gaps_.push_back(GAP_ESCAPE);
+      gaps_.push_back(static_cast<uint8_t>(half));
+      gaps_.push_back(static_cast<uint8_t>(half >> 8));
+    }
+  }
+  back_ = value;
+  ++size_;
+}
+
+template <typename T>
+T BasicGapStorage<T>::read_gap(size_t &offset) const noexcept {
+  uint8_t half = gaps_[offset++];
+  if (half != GAP_ESCAPE) {
+    return half ? static_cast<T>(half) * 2 : 1;
+  }
+  T wide = static_cast<T>(gaps_[offset] | (gaps_[offset + 1] << 8));
+  offset += 2;
+  return wide * 2;
+}
+
+template <typename T>
+T BasicGapStorage<T>::operator[](size_t pos) const noexcept {
+  size_t sample = pos / GAP_SAMPLE;
+  size_t offset = offsets_[sample];
+  T value = samples_[sample];
+  for (size_t i = pos % GAP_SAMPLE; i; --i) {
+    value += read_gap(offset);
+  }
+  return value;
+}
+
+template <typename T> T BasicGapStorage<T>::back() const noexcept {
+  return back_;
+}
+
+template <typename T> size_t BasicGapStorage<T>::size() const noexcept {
+  return size_;
+}
+
+template <typename T> size_t BasicGapStorage<T>::capacity() const noexcept {
+  size_t gaps = size_ + gaps_.capacity() - gaps_.size();
+  size_t samples = samples_.capacity() * GAP_SAMPLE;
+  return gaps < samples ? gaps : samples;
+}
+
+template <typename T> size_t BasicGapStorage<T>::memory() const noexcept {
+  return gaps_.capacity() + samples_.capacity() * sizeof(T) +
+         offsets_.capacity() * sizeof(size_t);
+}
+
+template <typename T> bool BasicGapStorage<T>::empty() const noexcept {
+  return size_ == 0;
+}
+
+template <typename T>
+typename BasicGapStorage<T>::const_iterator
+BasicGapStorage<T>::begin() const noexcept {
+  return const_iterator(this, 0);
+}
+
+template <typename T>
+typename BasicGapStorage<T>::const_iterator
+BasicGapStorage<T>::end() const noexcept {
+  return const_iterator(this, size_);
+}
+
+template <typename T>
+BasicGapStorage<T>::const_iterator::const_iterator() noexcept
+    : owner_{nullptr}, pos_{0}, offset_{0}, value_{0} {}
+
+template <typename T>
+BasicGapStorage<T>::const_iterator::const_iterator(
+    BasicGapStorage const *owner, size_t pos) noexcept
+    : owner_{owner}, pos_{pos}, offset_{0}, value_{0} {
+  if (pos < owner->size_) {
+    size_t sample = pos / GAP_SAMPLE;
+    offset_ = owner->offsets_[sample];
+    value_ = owner->samples_[sample];
+    for (size_t i = pos % GAP_SAMPLE; i; --i) {
+      value_ += owner->read_gap(offset_);
+    }
+  }
+}
+
+template <typename T>
+typename BasicGapStorage<T>::const_iterator &
+BasicGapStorage<T>::const_iterator::operator+=(difference_type diff) noexcept {
+  return *this = const_iterator(owner_, pos_ + static_cast<size_t>(diff));
+}
+
+template <typename T>
+typename BasicGapStorage<T>::const_iterator &
+BasicGapStorage<T>::const_iterator::operator-=(difference_type diff) noexcept {
+  return *this += -diff;
+}
+
+template <typename T>
+typename BasicGapStorage<T>::const_iterator &
+BasicGapStorage<T>::const_iterator::operator++() noexcept {
+  if (!value_ || pos_ + 1 >= owner_->size_) {
+    return *this += 1;
+  }
+  if (++pos_ % GAP_SAMPLE == 0) {
+    offset_ = owner_->offsets_[pos_ / GAP_SAMPLE];
+    value_ = owner_->samples_[pos_ / GAP_SAMPLE];
+  } else {
+    value_ += owner_->read_gap(offset_);
+  }
+  return *this;
+}
+
+template <typename T>
+typename BasicGapStorage<T>::const_iterator
+BasicGapStorage<T>::const_iterator::operator++(int) noexcept {
+  const_iterator tmp(*this);
+  ++*this;
+  return tmp;
+}
+
+template <typename T>
+typename BasicGapStorage<T>::const_iterator &
+BasicGapStorage<T>::const_iterator::operator--() noexcept {
+  return *this -= 1;
+}
+
+template <typename T>
+typename BasicGapStorage<T>::const_iterator
+BasicGapStorage<T>::const_iterator::operator--(int) noexcept {
+  const_iterator tmp(*this);
+  --*this;
+  return tmp;
+}
+
+template <typename T>
+T BasicGapStorage<T>::const_iterator::operator*() const noexcept {
+  return value_ ? value_ : (*owner_)[pos_];
+}
+
+template <typename T>
+T BasicGapStorage<T>::const_iterator::operator[](
+    difference_type diff) const noexcept {
+  return *(*this + diff);
+}
+
+template class BasicGapStorage<uint32_t>;
+template class BasicGapStorage<uint64_t>;
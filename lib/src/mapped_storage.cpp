@@ -0,0 +1,111 @@
+#include "../include/mapped_storage.h"
+
+#include <algorithm>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+template <typename T>
+BasicMappedStorage<T>::BasicMappedStorage() noexcept
+    : map_{nullptr}, length_{0}, mapped_{nullptr}, mapped_size_{0}, tail_{} {}
+
+template <typename T> BasicMappedStorage<T>::~BasicMappedStorage() {
+  unmap();
+}
+
+template <typename T>
+bool BasicMappedStorage<T>::map(int fd, size_t offset, size_t count) {
+  struct stat info;
+  if (offset % sizeof(T) != 0 || fstat(fd, &info) != 0 ||
+      static_cast<uint64_t>(info.st_size) < offset + count * sizeof(T)) {
+    return false;
+  }
+  size_t length = offset + count * sizeof(T);
+  void *map = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED) {
+    return false;
+  }
+  unmap();
+  map_ = map;
+  length_ = length;
+  mapped_ =
+      reinterpret_cast<const T *>(static_cast<const char *>(map) + offset);
+  mapped_size_ = count;
+  tail_.clear();
+  return true;
+}
+
+template <typename T> void BasicMappedStorage<T>::unmap() noexcept {
+  if (map_) {
+    munmap(map_, length_);
+  }
+  map_ = nullptr;
+  length_ = 0;
+  mapped_ = nullptr;
+  mapped_size_ = 0;
+}
+
+template <typename T> void BasicMappedStorage<T>::push_back(T value) {
+  tail_.push_back(value);
+}
+
+template <typename T> void BasicMappedStorage<T>::reserve(size_t count) {
+  if (count > mapped_size_) {
+    tail_.reserve(count - mapped_size_);
+  }
+}
+
+template <typename T>
+void BasicMappedStorage<T>::copy(size_t pos, size_t count,
+                                 T *out) const noexcept {
+  if (pos < mapped_size_) {
+    size_t part = std::min(count, mapped_size_ - pos);
+    out = std::copy(mapped_ + pos, mapped_ + pos + part, out);
+    pos += part;
+    count -= part;
+  }
+  std::copy(tail_.begin() + static_cast<std::ptrdiff_t>(pos - mapped_size_),
+            tail_.begin() +
+                static_cast<std::ptrdiff_t>(pos - mapped_size_ + count),
+            out);
+}
+
+template <typename T> T BasicMappedStorage<T>::back() const noexcept {
+  return tail_.empty() ? mapped_[mapped_size_ - 1] : tail_.back();
+}
+
+template <typename T> size_t BasicMappedStorage<T>::size() const noexcept {
+  return mapped_size_ + tail_.size();
+}
+
+template <typename T> size_t BasicMappedStorage<T>::mapped() const noexcept {
+  return mapped_size_;
+}
+
+template <typename T>
+size_t BasicMappedStorage<T>::capacity() const noexcept {
+  return mapped_size_ + tail_.capacity();
+}
+
+template <typename T> size_t BasicMappedStorage<T>::memory() const noexcept {
+  return length_ + tail_.capacity() * sizeof(T);
+}
+
+template <typename T> bool BasicMappedStorage<T>::empty() const noexcept {
+  return size() == 0;
+}
+
+template <typename T>
+typename BasicMappedStorage<T>::const_iterator
+BasicMappedStorage<T>::begin() const noexcept {
+  return const_iterator(this, 0);
+}
+
+template <typename T>
+typename BasicMappedStorage<T>::const_iterator
+BasicMappedStorage<T>::end() const noexcept {
+  return const_iterator(this, size());
+}
+
+template class BasicMappedStorage<uint32_t>;
+template class BasicMappedStorage<uint64_t>;
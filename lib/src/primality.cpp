@@ -0,0 +1,455 @@
+#include "../include/primality.h"
+
+#include "../include/small_primes.h"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define PRIMALITY_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+/**
+ * @brief Количество первых чисел \link SMALL_PRIMES \endlink, на которые
+ * делится проверяемое число перед тестом Миллера-Рабина.
+ */
+const size_t TRIAL_DIVISORS{16};
+/**
+ * @brief Квадрат первого простого числа, не участвующего в делении: числа
+ * меньше него, не делящиеся на первые TRIAL_DIVISORS простых, простые.
+ */
+const uint32_t TRIAL_BOUND{SMALL_PRIMES.values[TRIAL_DIVISORS] *
+                           SMALL_PRIMES.values[TRIAL_DIVISORS]};
+/**
+ * @brief Основания теста Миллера-Рабина, достаточные для n < 2^32.
+ */
+const uint32_t BASES32[]{2, 7, 61};
+/**
+ * @brief Основания теста Миллера-Рабина, достаточные для n < 2^64.
+ */
+const uint64_t BASES64[]{2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+/**
+ * @brief Количество 64-битных чисел, одновременно проверяемых пакетной
+ * функцией \link is_prime() \endlink.
+ */
+const size_t WIDE_LANES{4};
+
+/**
+ * @return Старшая половина произведения a * b.
+ */
+inline uint32_t mul_hi(uint32_t a, uint32_t b) noexcept {
+  return static_cast<uint32_t>((static_cast<uint64_t>(a) * b) >> 32);
+}
+
+inline uint64_t mul_hi(uint64_t a, uint64_t b) noexcept {
+#ifdef __SIZEOF_INT128__
+  return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#else
+  uint64_t a_lo = a & UINT32_MAX, a_hi = a >> 32;
+  uint64_t b_lo = b & UINT32_MAX, b_hi = b >> 32;
+  uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+  uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+  uint64_t middle = (lo_lo >> 32) + (hi_lo & UINT32_MAX) + lo_hi;
+  return hi_hi + (hi_lo >> 32) + (middle >> 32);
+#endif
+}
+
+/**
+ * @brief Арифметика Монтгомери по нечетному модулю n с R = 2^digits(T).
+ */
+template <typename T> struct Montgomery {
+  explicit Montgomery(T modulus) noexcept;
+
+  /**
+   * @return x * y / R mod n для x, y < n.
+   */
+  T mul(T x, T y) const noexcept {
+    T high = mul_hi(x, y);
+    T reduce = mul_hi(static_cast<T>(x * y * inverse), n);
+    return high >= reduce ? high - reduce : high - reduce + n;
+  }
+
+  /**
+   * @return a * R mod n.
+   */
+  T to(T a) const noexcept { return mul(a % n, r2); }
+
+  T n;
+  T inverse;
+  T one;
+  T minus_one;
+  T r2;
+};
+
+template <typename T>
+Montgomery<T>::Montgomery(T modulus) noexcept
+    : n{modulus}, inverse{modulus}, one{0}, minus_one{0}, r2{0} {
+  for (int i = 0; i < 6; ++i) {
+    inverse = static_cast<T>(inverse * (2 - n * inverse));
+  }
+  one = static_cast<T>(-n) % n;
+  minus_one = n - one;
+  r2 = one;
+  for (int i = 0; i < std::numeric_limits<T>::digits; ++i) {
+    r2 = r2 >= n - r2 ? r2 - (n - r2) : r2 + r2;
+  }
+}
+
+template <typename T> int bit_length(T value) noexcept {
+  int length = 0;
+  for (; value; value >>= 1) {
+    ++length;
+  }
+  return length;
+}
+
+/**
+ * @brief Прогон теста Миллера-Рабина для одного нечетного n > 3.
+ */
+template <typename T, typename Base, size_t Count>
+bool miller_rabin(T n, const Base (&bases)[Count]) noexcept {
+  Montgomery<T> mont(n);
+  T d = n - 1;
+  int s = 0;
+  for (; !(d & 1); d >>= 1) {
+    ++s;
+  }
+  int top = bit_length(d);
+  for (Base base : bases) {
+    T a = static_cast<T>(base % n);
+    if (a == 0) {
+      continue;
+    }
+    T am = mont.to(a);
+    T x = mont.one;
+    for (int bit = top - 1; bit >= 0; --bit) {
+      x = mont.mul(x, x);
+      if ((d >> bit) & 1) {
+        x = mont.mul(x, am);
+      }
+    }
+    if (x == mont.one || x == mont.minus_one) {
+      continue;
+    }
+    bool pass = false;
+    for (int r = 1; r < s && !pass; ++r) {
+      x = mont.mul(x, x);
+      pass = x == mont.minus_one;
+    }
+    if (!pass) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Один раунд теста Миллера-Рабина по основанию base для
+ * PRIMALITY_LANES нечетных чисел TRIAL_BOUND < n < 2^32.
+ */
+void miller_rabin_lanes_scalar(const uint32_t *n, uint32_t base,
+                               bool *pass) noexcept {
+  const uint32_t bases[1]{base};
+  for (size_t i = 0; i < PRIMALITY_LANES; ++i) {
+    pass[i] = miller_rabin(n[i], bases);
+  }
+}
+
+#ifdef PRIMALITY_X86
+static_assert(PRIMALITY_LANES == 8, "AVX2 kernel checks 8 numbers at once");
+
+/**
+ * @return x * y / 2^32 mod n в каждой 32-битной ячейке для x, y < n.
+ */
+__attribute__((target("avx2"))) inline __m256i
+mul_avx2(__m256i x, __m256i y, __m256i n, __m256i inverse) noexcept {
+  __m256i even = _mm256_mul_epu32(x, y);
+  __m256i odd =
+      _mm256_mul_epu32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32));
+  __m256i low = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+  __m256i high = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+  __m256i m = _mm256_mullo_epi32(low, inverse);
+  __m256i reduce = _mm256_blend_epi32(
+      _mm256_srli_epi64(_mm256_mul_epu32(m, n), 32),
+      _mm256_mul_epu32(_mm256_srli_epi64(m, 32), _mm256_srli_epi64(n, 32)),
+      0xAA);
+  __m256i no_borrow =
+      _mm256_cmpeq_epi32(_mm256_max_epu32(high, reduce), high);
+  return _mm256_add_epi32(_mm256_sub_epi32(high, reduce),
+                          _mm256_andnot_si256(no_borrow, n));
+}
+
+/**
+ * @brief Раунд теста Миллера-Рабина для 8 чисел в 32-битных ячейках AVX2.
+ *
+ * Все числа проходят max(bit_length(d)) шагов возведения в степень, а
+ * множитель на каждом шаге выбирается маской по общему номеру бита
+ * показателя. Возведение в квадрат после степени прекращается, как только
+ * результат известен для всех чисел.
+ */
+__attribute__((target("avx2"))) void
+miller_rabin_lanes_avx2(const uint32_t *n, uint32_t base, bool *pass) noexcept {
+  alignas(32) uint32_t d[8], s[8], one[8], am[8];
+  int top = 0;
+  uint32_t max_s = 0;
+  for (size_t i = 0; i < 8; ++i) {
+    s[i] = static_cast<uint32_t>(__builtin_ctz(n[i] - 1));
+    d[i] = (n[i] - 1) >> s[i];
+    one[i] = static_cast<uint32_t>((UINT64_C(1) << 32) % n[i]);
+    am[i] = static_cast<uint32_t>((static_cast<uint64_t>(base) << 32) % n[i]);
+    top = bit_length(d[i]) > top ? bit_length(d[i]) : top;
+    max_s = s[i] > max_s ? s[i] : max_s;
+  }
+  const __m256i mod = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(n));
+  const __m256i ones = _mm256_set1_epi32(1);
+  __m256i inverse = mod;
+  for (int i = 0; i < 5; ++i) {
+    inverse = _mm256_mullo_epi32(
+        inverse, _mm256_sub_epi32(_mm256_set1_epi32(2),
+                                  _mm256_mullo_epi32(mod, inverse)));
+  }
+  const __m256i exponent =
+      _mm256_load_si256(reinterpret_cast<const __m256i *>(d));
+  const __m256i unit =
+      _mm256_load_si256(reinterpret_cast<const __m256i *>(one));
+  const __m256i minus_one = _mm256_sub_epi32(mod, unit);
+  const __m256i factor =
+      _mm256_load_si256(reinterpret_cast<const __m256i *>(am));
+  __m256i x = unit;
+  for (int bit = top - 1; bit >= 0; --bit) {
+    __m256i mask = _mm256_cmpeq_epi32(
+        _mm256_and_si256(_mm256_srli_epi32(exponent, bit), ones), ones);
+    x = mul_avx2(x, x, mod, inverse);
+    x = mul_avx2(x, _mm256_blendv_epi8(unit, factor, mask), mod, inverse);
+  }
+  __m256i passed = _mm256_or_si256(_mm256_cmpeq_epi32(x, unit),
+                                   _mm256_cmpeq_epi32(x, minus_one));
+  const __m256i steps = _mm256_load_si256(reinterpret_cast<const __m256i *>(s));
+  for (uint32_t r = 1; r < max_s; ++r) {
+    __m256i open = _mm256_andnot_si256(
+        passed, _mm256_cmpgt_epi32(steps, _mm256_set1_epi32(
+                                              static_cast<int>(r))));
+    if (_mm256_testz_si256(open, open)) {
+      break;
+    }
+    x = mul_avx2(x, x, mod, inverse);
+    passed = _mm256_or_si256(
+        passed, _mm256_and_si256(open, _mm256_cmpeq_epi32(x, minus_one)));
+  }
+  int bits = _mm256_movemask_ps(_mm256_castsi256_ps(passed));
+  for (size_t i = 0; i < 8; ++i) {
+    pass[i] = (bits >> i) & 1;
+  }
+}
+#endif
+
+/**
+ * @brief Функция раунда теста Миллера-Рабина для группы из PRIMALITY_LANES
+ * чисел.
+ */
+using LanesKernel = void (*)(const uint32_t *, uint32_t, bool *) noexcept;
+
+/**
+ * @return Реализация раунда для группы чисел для набора инструкций
+ * процессора.
+ */
+LanesKernel miller_rabin_lanes() noexcept {
+#ifdef PRIMALITY_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return miller_rabin_lanes_avx2;
+  }
+#endif
+  return miller_rabin_lanes_scalar;
+}
+
+/**
+ * @brief Отсев делением на малые простые числа.
+ * @return 0 - составное, 1 - простое, 2 - требуется тест Миллера-Рабина.
+ */
+template <typename T> int small_check(T n) noexcept {
+  if (n < 2) {
+    return 0;
+  }
+  for (size_t i = 0; i < TRIAL_DIVISORS; ++i) {
+    uint32_t prime = SMALL_PRIMES.values[i];
+    if (n % prime == 0) {
+      return n == prime ? 1 : 0;
+    }
+  }
+  return n < TRIAL_BOUND ? 1 : 2;
+}
+
+/**
+ * @brief Проверяет числа меньше 2^32 группами по PRIMALITY_LANES.
+ *
+ * Основания перебираются по очереди для всех чисел сразу: числа, не
+ * прошедшие очередной раунд, выбывают, и группы следующего раунда
+ * составляются только из оставшихся.
+ */
+void flush_lanes(std::vector<uint32_t> &values, std::vector<size_t> &positions,
+                 std::vector<bool> &out) {
+  static const LanesKernel kernel = miller_rabin_lanes();
+  const size_t lanes = PRIMALITY_LANES;
+  uint32_t group[lanes];
+  bool pass[lanes];
+  for (uint32_t base : BASES32) {
+    size_t kept = 0;
+    for (size_t first = 0; first < values.size(); first += lanes) {
+      for (size_t i = 0; i < lanes; ++i) {
+        group[i] =
+            first + i < values.size() ? values[first + i] : values[first];
+      }
+      kernel(group, base, pass);
+      for (size_t i = 0; i < lanes && first + i < values.size(); ++i) {
+        if (pass[i]) {
+          values[kept] = group[i];
+          positions[kept++] = positions[first + i];
+        }
+      }
+    }
+    values.resize(kept);
+    positions.resize(kept);
+  }
+  for (size_t pos : positions) {
+    out[pos] = true;
+  }
+}
+
+/**
+ * @brief 64-битное число, ожидающее раундов теста Миллера-Рабина в \link
+ * flush_wide() \endlink: параметры Монтгомери и разложение n - 1 = d * 2^s
+ * вычисляются один раз для всех оснований.
+ */
+struct WideCandidate {
+  Montgomery<uint64_t> mont;
+  uint64_t d;
+  int s;
+  size_t pos;
+};
+
+/**
+ * @brief Раунд теста Миллера-Рабина по основанию base для WIDE_LANES чисел.
+ *
+ * Цепочки умножений чисел независимы и чередуются в одном цикле по общему
+ * номеру бита показателя, поэтому процессор выполняет их умножения
+ * параллельно. Множитель выбирается маской, а не ветвлением.
+ */
+void miller_rabin_wide(const WideCandidate *c, uint64_t base,
+                       bool *pass) noexcept {
+  const size_t lanes = WIDE_LANES;
+  uint64_t x[lanes], am[lanes];
+  int top = 0;
+  int max_s = 0;
+  for (size_t i = 0; i < lanes; ++i) {
+    am[i] = c[i].mont.to(base);
+    x[i] = c[i].mont.one;
+    top = bit_length(c[i].d) > top ? bit_length(c[i].d) : top;
+    max_s = c[i].s > max_s ? c[i].s : max_s;
+  }
+  for (int bit = top - 1; bit >= 0; --bit) {
+    for (size_t i = 0; i < lanes; ++i) {
+      uint64_t mask = 0 - ((c[i].d >> bit) & 1);
+      uint64_t square = c[i].mont.mul(x[i], x[i]);
+      x[i] = c[i].mont.mul(square, (am[i] & mask) | (c[i].mont.one & ~mask));
+    }
+  }
+  bool done = true;
+  for (size_t i = 0; i < lanes; ++i) {
+    pass[i] = x[i] == c[i].mont.one || x[i] == c[i].mont.minus_one;
+    done = done && (pass[i] || c[i].s <= 1);
+  }
+  for (int r = 1; r < max_s && !done; ++r) {
+    done = true;
+    for (size_t i = 0; i < lanes; ++i) {
+      x[i] = c[i].mont.mul(x[i], x[i]);
+      pass[i] = pass[i] || (r < c[i].s && x[i] == c[i].mont.minus_one);
+      done = done && (pass[i] || r + 1 >= c[i].s);
+    }
+  }
+}
+
+/**
+ * @brief Проверяет числа не меньше 2^32 группами по WIDE_LANES, так же
+ * выбывая после первого непройденного раунда, как в \link flush_lanes()
+ * \endlink.
+ */
+void flush_wide(std::vector<WideCandidate> &candidates,
+                std::vector<bool> &out) {
+  const size_t lanes = WIDE_LANES;
+  bool pass[lanes];
+  for (uint64_t base : BASES64) {
+    size_t kept = 0;
+    for (size_t first = 0; first < candidates.size(); first += lanes) {
+      size_t count = std::min(lanes, candidates.size() - first);
+      if (count < lanes) {
+        std::vector<WideCandidate> group(lanes, candidates[first]);
+        std::copy(candidates.begin() + static_cast<ptrdiff_t>(first),
+                  candidates.end(), group.begin());
+        miller_rabin_wide(group.data(), base, pass);
+      } else {
+        miller_rabin_wide(candidates.data() + first, base, pass);
+      }
+      for (size_t i = 0; i < count; ++i) {
+        if (pass[i]) {
+          candidates[kept++] = candidates[first + i];
+        }
+      }
+    }
+    candidates.erase(candidates.begin() + static_cast<ptrdiff_t>(kept),
+                     candidates.end());
+  }
+  for (WideCandidate const &candidate : candidates) {
+    out[candidate.pos] = true;
+  }
+}
+} // namespace
+
+template <typename T> bool is_prime(T n) noexcept {
+  int small = small_check(n);
+  if (small != 2) {
+    return small == 1;
+  }
+  if (n <= UINT32_MAX) {
+    return miller_rabin(static_cast<uint32_t>(n), BASES32);
+  }
+  return miller_rabin(static_cast<uint64_t>(n), BASES64);
+}
+
+template <typename T>
+void is_prime(const T *first, const T *last, std::vector<bool> &out) {
+  out.assign(static_cast<size_t>(last - first), false);
+  std::vector<uint32_t> narrow;
+  std::vector<size_t> positions;
+  std::vector<WideCandidate> wide;
+  for (const T *it = first; it != last; ++it) {
+    size_t pos = static_cast<size_t>(it - first);
+    int small = small_check(*it);
+    if (small != 2) {
+      out[pos] = small == 1;
+    } else if (*it <= UINT32_MAX) {
+      narrow.push_back(static_cast<uint32_t>(*it));
+      positions.push_back(pos);
+    } else {
+      uint64_t n = static_cast<uint64_t>(*it);
+      WideCandidate candidate{Montgomery<uint64_t>(n), n - 1, 0, pos};
+      for (; !(candidate.d & 1); candidate.d >>= 1) {
+        ++candidate.s;
+      }
+      wide.push_back(candidate);
+    }
+  }
+  flush_lanes(narrow, positions, out);
+  if (!wide.empty()) {
+    flush_wide(wide, out);
+  }
+}
+
+template bool is_prime<uint32_t>(uint32_t n) noexcept;
+template bool is_prime<uint64_t>(uint64_t n) noexcept;
+template void is_prime<uint32_t>(const uint32_t *first, const uint32_t *last,
+                                 std::vector<bool> &out);
+template void is_prime<uint64_t>(const uint64_t *first, const uint64_t *last,
+                                 std::vector<bool> &out);
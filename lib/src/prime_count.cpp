@@ -0,0 +1,213 @@
+#include "../include/prime_count.h"
+#include "../include/wheel_sieve.h"
+
+#include <bitset>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+/**
+ * @brief Количество чисел, описываемых одним 64-битным словом таблицы pi.
+ */
+const uint32_t WORD_SPAN{8 * WHEEL_SIZE};
+/**
+ * @brief Количество первых простых чисел, для которых phi(x, k) вычисляется
+ * по периодической таблице.
+ */
+const size_t PHI_SMALL{6};
+/**
+ * @brief Первые PHI_SMALL простых чисел.
+ */
+const uint32_t PHI_PRIMES[PHI_SMALL]{2, 3, 5, 7, 11, 13};
+/**
+ * @brief Целая часть кубического корня из UINT64_MAX: куб любого большего
+ * числа выходит за границы uint64_t.
+ */
+const uint64_t UINT64_MAX_CBRT{2642245};
+
+uint32_t integer_cbrt(uint64_t value) noexcept {
+  uint64_t root = static_cast<uint64_t>(std::cbrt(static_cast<double>(value)));
+  if (root > UINT64_MAX_CBRT) {
+    root = UINT64_MAX_CBRT;
+  }
+  while (root * root * root > value) {
+    --root;
+  }
+  while (root < UINT64_MAX_CBRT &&
+         (root + 1) * (root + 1) * (root + 1) <= value) {
+    ++root;
+  }
+  return static_cast<uint32_t>(root);
+}
+
+/**
+ * @brief Таблица pi(y) для y <= limit.
+ *
+ * Хранит битовую карту решета на колесе 30 словами по 64 бита и количество
+ * простых чисел перед каждым словом.
+ */
+class PiTable {
+public:
+  explicit PiTable(uint64_t limit);
+
+  uint64_t operator()(uint64_t y) const noexcept;
+
+  uint64_t limit() const noexcept { return limit_; }
+
+private:
+  std::vector<uint64_t> words_;
+  std::vector<uint64_t> counts_;
+  uint64_t masks_[WORD_SPAN];
+  uint64_t limit_;
+};
+
+PiTable::PiTable(uint64_t limit)
+    : words_(limit / WORD_SPAN + 1, 0), counts_{}, masks_{}, limit_{limit} {
+  std::vector<uint32_t> base = primes_up_to(integer_sqrt(limit));
+  WheelSieve sieve;
+  const uint64_t step = static_cast<uint64_t>(WORD_SPAN) * 4096;
+  uint8_t *bytes = reinterpret_cast<uint8_t *>(words_.data());
+  for (uint64_t lo = 0; lo <= limit; lo += step) {
+    uint64_t hi = limit - lo < step ? limit : lo + step - 1;
+    sieve.sieve(lo, hi, base.data(), base.data() + base.size());
+    std::memcpy(bytes + lo / WHEEL_SIZE, sieve.bitmap().data(),
+                sieve.bitmap().size());
+  }
+  counts_.reserve(words_.size());
+  uint64_t total = 0;
+  for (uint64_t word : words_) {
+    counts_.push_back(total);
+    total += std::bitset<64>(word).count();
+  }
+  for (uint32_t rest = 0; rest < WORD_SPAN; ++rest) {
+    for (uint32_t bit = 0; bit < 64; ++bit) {
+      if ((bit / 8) * WHEEL_SIZE + WHEEL_RESIDUES[bit % 8] <= rest) {
+        masks_[rest] |= UINT64_C(1) << bit;
+      }
+    }
+  }
+}
+
+uint64_t PiTable::operator()(uint64_t y) const noexcept {
+  static const uint8_t small[7]{0, 0, 1, 2, 2, 3, 3};
+  if (y < 7) {
+    return small[y];
+  }
+  uint64_t word = y / WORD_SPAN;
+  return 3 + counts_[word] +
+         std::bitset<64>(words_[word] & masks_[y % WORD_SPAN]).count();
+}
+
+/**
+ * @brief Периодические таблицы phi(x, k) для k <= PHI_SMALL.
+ */
+struct PhiTables {
+  PhiTables();
+
+  std::vector<uint64_t> primorials;
+  std::vector<std::vector<uint16_t>> tables;
+};
+
+PhiTables::PhiTables() : primorials{1}, tables{} {
+  tables.emplace_back(1, 0);
+  for (size_t k = 1; k <= PHI_SMALL; ++k) {
+    primorials.push_back(primorials.back() * PHI_PRIMES[k - 1]);
+    std::vector<uint16_t> table(primorials.back());
+    uint16_t total = 0;
+    for (uint32_t rest = 0; rest < primorials.back(); ++rest) {
+      bool coprime = rest != 0;
+      for (size_t i = 0; i < k && coprime; ++i) {
+        coprime = rest % PHI_PRIMES[i] != 0;
+      }
+      total = static_cast<uint16_t>(total + coprime);
+      table[rest] = total;
+    }
+    tables.push_back(table);
+  }
+}
+
+PhiTables const &phi_tables() {
+  static const PhiTables tables;
+  return tables;
+}
+
+/**
+ * @brief Вычисление pi(x) по формуле Мейсселя.
+ */
+class Meissel {
+public:
+  explicit Meissel(uint64_t x);
+
+  uint64_t count() const noexcept;
+
+private:
+  uint64_t phi(uint64_t x, size_t a) const noexcept;
+  uint64_t phi_small(uint64_t x, size_t a) const noexcept;
+
+  uint64_t x_;
+  uint32_t cbrt_;
+  PiTable pi_;
+  std::vector<uint32_t> primes_;
+  PhiTables const &small_;
+};
+
+Meissel::Meissel(uint64_t x)
+    : x_{x}, cbrt_{integer_cbrt(x)}, pi_{x / integer_cbrt(x)},
+      primes_{primes_up_to(integer_sqrt(x))}, small_{phi_tables()} {}
+
+uint64_t Meissel::phi_small(uint64_t x, size_t a) const noexcept {
+  if (a == 0) {
+    return x;
+  }
+  uint64_t period = small_.primorials[a];
+  std::vector<uint16_t> const &table = small_.tables[a];
+  return x / period * table.back() + table[x % period];
+}
+
+uint64_t Meissel::phi(uint64_t x, size_t a) const noexcept {
+  if (a <= PHI_SMALL) {
+    return phi_small(x, a);
+  }
+  uint64_t largest = primes_[a - 1];
+  if (x <= pi_.limit() && largest * largest > x) {
+    uint64_t count = pi_(x);
+    return count >= a ? count - a + 1 : 1;
+  }
+  uint64_t result = phi_small(x, PHI_SMALL);
+  for (size_t i = PHI_SMALL; i < a; ++i) {
+    uint64_t y = x / primes_[i];
+    if (y < primes_[i]) {
+      result -= a - i;
+      break;
+    }
+    result -= phi(y, i);
+  }
+  return result;
+}
+
+uint64_t Meissel::count() const noexcept {
+  size_t a = static_cast<size_t>(pi_(cbrt_));
+  uint64_t result = phi(x_, a) + a - 1;
+  for (size_t i = a; i < primes_.size(); ++i) {
+    result -= pi_(x_ / primes_[i]) - i;
+  }
+  return result;
+}
+} // namespace
+
+template <typename T> T count_primes(T x) {
+  return x < 2 ? 0 : static_cast<T>(Meissel(x).count());
+}
+
+template <typename T> T count_primes(T lo, T hi) {
+  if (lo > hi) {
+    return 0;
+  }
+  return count_primes(hi) - (lo ? count_primes(static_cast<T>(lo - 1)) : 0);
+}
+
+template uint32_t count_primes<uint32_t>(uint32_t x);
+template uint64_t count_primes<uint64_t>(uint64_t x);
+template uint32_t count_primes<uint32_t>(uint32_t lo, uint32_t hi);
+template uint64_t count_primes<uint64_t>(uint64_t lo, uint64_t hi);
@@ -0,0 +1,50 @@
+#include "../include/prime_filters.h"
+#include "../include/primality.h"
+
+namespace {
+/**
+ * @brief Наибольший показатель, при котором квадрат остатка по модулю
+ * 2^exponent - 1 помещается в 64 бита.
+ */
+const uint32_t NARROW_EXPONENT{31};
+
+/**
+ * @brief Приведение value по модулю 2^exponent - 1 сложением старших и
+ * младших exponent бит.
+ */
+template <typename T>
+uint64_t mersenne_mod(T value, uint32_t exponent, uint64_t modulus) noexcept {
+  while (value > modulus) {
+    value = (value & modulus) + (value >> exponent);
+  }
+  return value == modulus ? 0 : static_cast<uint64_t>(value);
+}
+
+template <typename T>
+bool lucas_lehmer_test(uint32_t exponent, uint64_t modulus) noexcept {
+  uint64_t s = 4;
+  for (uint32_t i = 2; i < exponent; ++i) {
+    s = mersenne_mod(static_cast<T>(s) * s, exponent, modulus);
+    s = s >= 2 ? s - 2 : s + modulus - 2;
+  }
+  return s == 0;
+}
+} // namespace
+
+bool lucas_lehmer(uint32_t exponent) noexcept {
+  if (exponent >= 64 || !is_prime(exponent)) {
+    return false;
+  }
+  if (exponent == 2) {
+    return true;
+  }
+  uint64_t modulus = (UINT64_C(1) << exponent) - 1;
+  if (exponent <= NARROW_EXPONENT) {
+    return lucas_lehmer_test<uint64_t>(exponent, modulus);
+  }
+#ifdef __SIZEOF_INT128__
+  return lucas_lehmer_test<unsigned __int128>(exponent, modulus);
+#else
+  return is_prime(modulus);
+#endif
+}
@@ -0,0 +1,49 @@
+#include "../include/prime_reducers.h"
+
+PrimeCounter::PrimeCounter() noexcept : count_{0} {}
+
+void PrimeCounter::operator()(WheelSieve const &segment) noexcept {
+  count_ += segment.count();
+}
+
+uint64_t PrimeCounter::count() const noexcept { return count_; }
+
+PrimeSum::PrimeSum() noexcept : sum_{0} {}
+
+void PrimeSum::operator()(WheelSieve const &segment) noexcept {
+  segment.for_each_prime([this](uint64_t prime) { sum_ += prime; });
+}
+
+uint64_t PrimeSum::sum() const noexcept { return sum_; }
+
+GapStats::GapStats() noexcept
+    : histogram_{}, last_{0}, max_gap_{0}, max_gap_start_{0} {}
+
+void GapStats::operator()(WheelSieve const &segment) {
+  segment.for_each_prime([this](uint64_t prime) {
+    if (last_) {
+      uint64_t gap = prime - last_;
+      if (gap >= histogram_.size()) {
+        histogram_.resize(static_cast<size_t>(gap) + 1, 0);
+      }
+      ++histogram_[static_cast<size_t>(gap)];
+      if (gap > max_gap_) {
+        max_gap_ = gap;
+        max_gap_start_ = last_;
+      }
+    }
+    last_ = prime;
+  });
+}
+
+uint64_t GapStats::max_gap() const noexcept { return max_gap_; }
+
+uint64_t GapStats::max_gap_start() const noexcept { return max_gap_start_; }
+
+uint64_t GapStats::twins() const noexcept {
+  return histogram_.size() > 2 ? histogram_[2] : 0;
+}
+
+const std::vector<uint64_t> &GapStats::histogram() const noexcept {
+  return histogram_;
+}
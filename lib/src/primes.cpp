@@ -1,282 +1,922 @@
 #include "../include/primes.h"
+#include "../include/prime_count.h"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+/**
+ * @return Первое число, квадрат которого выходит за границы типа T.
+ */
+template <typename T> constexpr uint64_t max_sqrt() noexcept {
+  return UINT64_C(1) << (std::numeric_limits<T>::digits / 2);
+}
 
-PrimesCache Primes::data_ = PrimesCache{};
+/**
+ * @param prime
+ * @return true если prime нужно добавить к простым числам для просеивания
+ * значений типа T: числа меньше \link SMALL_PRIMES_LIMIT \endlink уже
+ * взяты из \link SMALL_PRIMES \endlink.
+ */
+template <typename T> constexpr bool is_base_prime(uint64_t prime) noexcept {
+  return prime >= SMALL_PRIMES_LIMIT && prime < max_sqrt<T>();
+}
 
-PrimesCache::PrimesCache() : data_{}, last_checked_{FIRST_SECTOR - 1} {
-#ifdef DEBUG_MODE
-  std::cout << "PrimesCache creating..." << std::endl;
-  auto start_time = std::chrono::high_resolution_clock::now();
-#endif
-  std::vector<bool> tmp(FIRST_SECTOR, true);
-  for (uint32_t prime = 2; prime < FIRST_SECTOR; ++prime) {
-    if (!tmp[prime]) {
-      continue;
+/**
+ * @brief Счетчик попаданий потока в кэш с номером owner.
+ */
+struct HitSlot {
+  uint64_t owner;
+  std::atomic<uint64_t> *counter;
+};
+
+/**
+ * @brief Счетчики попаданий текущего потока в последние использованные кэши,
+ * по одному на остаток номера кэша от деления на HIT_SLOTS.
+ */
+thread_local HitSlot hit_slots[HIT_SLOTS]{};
+
+/**
+ * @brief Номер следующего созданного кэша. Номера не повторяются, поэтому
+ * счетчик удаленного кэша не достанется новому кэшу по тому же адресу.
+ */
+std::atomic<uint64_t> next_cache_id{1};
+
+/**
+ * @param n
+ * @return Нижняя оценка n-го простого числа (Dusart, 1999):
+ * p_n >= n (ln n + ln ln n - 1).
+ */
+uint64_t nth_prime_lower(uint64_t n) noexcept {
+  if (n < 2) {
+    return 2;
+  }
+  double ln = std::log(static_cast<double>(n));
+  double estimate = static_cast<double>(n) * (ln + std::log(ln) - 1);
+  return estimate < 2 ? 2 : static_cast<uint64_t>(estimate * (1 - 1e-9));
+}
+
+/**
+ * @param n
+ * @return Верхняя оценка n-го простого числа (Rosser, 1941):
+ * p_n <= n (ln n + ln ln n) при n >= 6, либо UINT64_MAX, если оценка не
+ * помещается в uint64_t.
+ */
+uint64_t nth_prime_upper(uint64_t n) noexcept {
+  if (n < 6) {
+    return 13;
+  }
+  double ln = std::log(static_cast<double>(n));
+  double estimate = static_cast<double>(n) * (ln + std::log(ln)) * (1 + 1e-9);
+  return estimate >= 1.8e19 ? UINT64_MAX : static_cast<uint64_t>(estimate) + 1;
+}
+
+/**
+ * @param x
+ * @return Верхняя оценка количества простых чисел, не превышающих x (Rosser,
+ * Schoenfeld, 1962; Dusart, 2010).
+ */
+uint64_t prime_count_upper(uint64_t x) noexcept {
+  if (x < 2) {
+    return 0;
+  }
+  double ln = std::log(static_cast<double>(x));
+  double estimate = x < 355991 ? 1.25506 * static_cast<double>(x) / ln
+                               : static_cast<double>(x) / ln *
+                                     (1 + 1 / ln + 2.51 / (ln * ln));
+  return static_cast<uint64_t>(estimate) + 1;
+}
+
+/**
+ * @brief Резервирует место для count значений, если хранилище это
+ * поддерживает.
+ */
+template <typename Storage>
+auto reserve_storage(Storage &data, size_t count, int)
+    -> decltype(data.reserve(count), void()) {
+  data.reserve(count);
+}
+
+template <typename Storage>
+void reserve_storage(Storage &, size_t, long) {}
+
+/**
+ * @brief Наибольшее время ожидания фонового потока между проверками запаса
+ * найденных чисел в миллисекундах.
+ */
+const uint32_t PREFETCH_POLL{50};
+
+/**
+ * @brief Количество подряд идущих секторов, которые поток \link
+ * BasicPrimesCache::fill() \endlink забирает из общего счетчика за раз:
+ * внутри них решето продолжает просеивание без пересчета кратных.
+ */
+const uint64_t CLAIM_SECTORS{2};
+
+/**
+ * @brief Хранилища, которые можно читать во время добавления новых значений.
+ */
+template <typename Storage> struct concurrent_storage : std::false_type {};
+
+template <typename T>
+struct concurrent_storage<BasicChunkedStorage<T>> : std::true_type {};
+
+/**
+ * @brief Копирует count значений начиная с позиции pos методом copy()
+ * хранилища.
+ */
+template <typename Storage>
+auto copy_values(Storage const &data, size_t pos, size_t count,
+                 typename Storage::value_type *out, int)
+    -> decltype(data.copy(pos, count, out), void()) {
+  data.copy(pos, count, out);
+}
+
+/**
+ * @brief Копирует count значений начиная с позиции pos через итераторы.
+ */
+template <typename Storage>
+void copy_values(Storage const &data, size_t pos, size_t count,
+                 typename Storage::value_type *out, long) {
+  std::copy_n(data.begin() + static_cast<std::ptrdiff_t>(pos), count, out);
+}
+
+/**
+ * @brief Сигнатура файла кэша.
+ */
+const char CACHE_FILE_MAGIC[8]{"PRIMESC"};
+
+/**
+ * @brief Заголовок файла кэша.
+ */
+struct CacheFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t width;
+  uint64_t count;
+  uint64_t last_checked;
+};
+
+bool read_header(int fd, CacheFileHeader &header) noexcept {
+  return pread(fd, &header, sizeof(header), 0) ==
+             static_cast<ssize_t>(sizeof(header)) &&
+         std::memcmp(header.magic, CACHE_FILE_MAGIC, sizeof(header.magic)) ==
+             0 &&
+         header.version == CACHE_FILE_VERSION;
+}
+
+bool write_all(int fd, const void *data, size_t size,
+               uint64_t offset) noexcept {
+  const char *bytes = static_cast<const char *>(data);
+  while (size) {
+    ssize_t written = pwrite(fd, bytes, size, static_cast<off_t>(offset));
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
     }
-    data_.push_back(prime);
-    for (uint32_t not_prime = prime * prime; not_prime < FIRST_SECTOR;
-         not_prime += prime) {
-      tmp[not_prime] = false;
+    bytes += written;
+    size -= static_cast<size_t>(written);
+    offset += static_cast<uint64_t>(written);
+  }
+  return true;
+}
+
+/**
+ * @brief Записывает значения [first, last) в файл начиная со смещения offset
+ * блоками по SECTOR_SIZE байт.
+ */
+template <typename T, typename Iterator>
+bool write_values(int fd, Iterator first, Iterator last, uint64_t offset) {
+  const size_t block = SECTOR_SIZE / sizeof(T);
+  std::vector<T> buffer;
+  buffer.reserve(block);
+  while (first != last) {
+    buffer.clear();
+    for (; first != last && buffer.size() < block; ++first) {
+      buffer.push_back(*first);
+    }
+    if (!write_all(fd, buffer.data(), buffer.size() * sizeof(T), offset)) {
+      return false;
     }
+    offset += buffer.size() * sizeof(T);
   }
-#ifdef DEBUG_MODE
-  auto end_time = std::chrono::high_resolution_clock::now();
-  auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(end_time -
-                                                                    start_time)
-                  .count();
-  std::cout << "PrimesCache creating finished in " << diff << "ms" << std::endl;
-#endif
-}
-
-void PrimesCache::add_primes() {
-#ifdef DEBUG_MODE
-  std::cout << "Adding primes to PrimesCache..." << std::endl;
-  auto start_time = std::chrono::high_resolution_clock::now();
-  uint32_t start_size = static_cast<uint32_t>(data_.size());
-#endif
-  std::vector<bool> tmp(SECTOR_SIZE, true);
-  uint32_t tmp_size = (UINT32_MAX - last_checked_ > SECTOR_SIZE)
-                          ? SECTOR_SIZE
-                          : UINT32_MAX - last_checked_;
-  for (uint32_t p : data_) {
-    uint32_t not_p = p + p * (last_checked_ / p) - last_checked_ - 1;
-    if (not_p >= tmp_size) {
+  return true;
+}
+
+/**
+ * @brief Дополняет data значениями файла кэша fd до count.
+ */
+template <typename Storage>
+bool load_values(Storage &data, int fd, size_t count) {
+  BasicMappedStorage<typename Storage::value_type> file;
+  if (!file.map(fd, sizeof(CacheFileHeader), count)) {
+    return false;
+  }
+  for (size_t i = data.size(); i < count; ++i) {
+    data.push_back(file[i]);
+  }
+  return true;
+}
+
+/**
+ * @brief Заменяет содержимое data отображением файла кэша fd.
+ */
+template <typename T>
+bool load_values(BasicMappedStorage<T> &data, int fd, size_t count) {
+  return data.map(fd, sizeof(CacheFileHeader), count);
+}
+/**
+ * @return Объем памяти, занимаемой хранилищем, в байтах.
+ */
+template <typename Storage> size_t storage_memory(Storage const &data) {
+  return data.memory();
+}
+
+template <typename T> size_t storage_memory(std::vector<T> const &data) {
+  return data.capacity() * sizeof(T);
+}
+
+/**
+ * @return Время, прошедшее с start, в наносекундах.
+ */
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point start) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count());
+}
+} // namespace
+
+std::string to_json(PrimesCacheStats const &stats) {
+  std::string result;
+  const std::pair<const char *, uint64_t> fields[]{
+      {"size", stats.size},
+      {"capacity", stats.capacity},
+      {"memory", stats.memory},
+      {"last_checked", stats.last_checked},
+      {"sectors", stats.sectors},
+      {"sieve_ns", stats.sieve_ns},
+      {"sector_ns", stats.sectors ? stats.sieve_ns / stats.sectors : 0},
+      {"grows", stats.grows},
+      {"hits", stats.hits},
+      {"misses", stats.misses},
+      {"transient", stats.transient}};
+  for (std::pair<const char *, uint64_t> const &field : fields) {
+    result += result.empty() ? "{\"" : ", \"";
+    result += field.first;
+    result += "\": ";
+    result += std::to_string(field.second);
+  }
+  return result + "}";
+}
+
+template <typename Storage>
+BasicPrimesCache<Storage>::BasicPrimesCache()
+    : data_{}, base_{}, last_checked_{FIRST_SECTOR - 1}, sieve_{}, mutex_{},
+      wake_{}, prefetcher_{}, refill_at_{UINT64_MAX}, demand_{0}, ahead_{0},
+      hits_{}, id_{next_cache_id.fetch_add(1, std::memory_order_relaxed)},
+      misses_{0}, transient_{0}, sectors_{0}, sieve_ns_{0}, grows_{0} {
+  for (uint32_t prime : SMALL_PRIMES) {
+    if (prime >= FIRST_SECTOR) {
       break;
     }
-    for (; not_p < tmp_size; not_p += p) {
-      tmp[not_p] = false;
+    data_.push_back(prime);
+  }
+}
+
+template <typename Storage> BasicPrimesCache<Storage>::~BasicPrimesCache() {
+  prefetch(0);
+}
+
+template <typename Storage> void BasicPrimesCache<Storage>::add_primes() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  grow();
+}
+
+template <typename Storage> void BasicPrimesCache<Storage>::grow() {
+  const value_type max = std::numeric_limits<value_type>::max();
+  value_type tmp_size =
+      (max - last_checked_ > SECTOR_SIZE) ? SECTOR_SIZE : max - last_checked_;
+  if (tmp_size) {
+    auto start = std::chrono::steady_clock::now();
+    size_t capacity = data_.capacity();
+    sieve_.sieve(static_cast<uint64_t>(last_checked_) + 1,
+                 static_cast<uint64_t>(last_checked_) + tmp_size,
+                 SMALL_PRIMES.begin(), SMALL_PRIMES.end(), base_.data(),
+                 base_.data() + base_.size());
+    sieve_.for_each_prime([this](uint64_t prime) {
+      data_.push_back(static_cast<value_type>(prime));
+      if (is_base_prime<value_type>(prime)) {
+        base_.push_back(static_cast<uint32_t>(prime));
+      }
+    });
+    grows_ += data_.capacity() != capacity;
+    sieve_ns_ += elapsed_ns(start);
+    ++sectors_;
+  }
+  last_checked_ += tmp_size;
+}
+
+template <typename Storage>
+void BasicPrimesCache<Storage>::reserve(value_type max_value) {
+  uint64_t count = prime_count_upper(max_value);
+  if (count > data_.size() && count <= RESERVE_LIMIT) {
+    reserve_storage(data_, static_cast<size_t>(count), 0);
+  }
+}
+
+template <typename Storage>
+void BasicPrimesCache<Storage>::fill(value_type max_value, uint32_t threads) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  reserve(max_value);
+  while (last_checked_ < max_value &&
+         (last_checked_ < max_sqrt<value_type>() &&
+          static_cast<uint64_t>(last_checked_) * last_checked_ < max_value)) {
+    grow();
+  }
+  if (threads == 0) {
+    threads = std::thread::hardware_concurrency();
+  }
+  if (threads <= 1) {
+    while (last_checked_ < max_value) {
+      grow();
     }
+    return;
   }
-  for (uint32_t i = 0; i < tmp_size; ++i) {
-    if (tmp[i]) {
-      data_.push_back(i + last_checked_ + 1);
+  while (last_checked_ < max_value) {
+    uint64_t first = static_cast<uint64_t>(last_checked_) + 1;
+    uint64_t sectors = (max_value - last_checked_ - 1) / SECTOR_SIZE + 1;
+    if (sectors > static_cast<uint64_t>(threads) * THREAD_SECTORS) {
+      sectors = static_cast<uint64_t>(threads) * THREAD_SECTORS;
+    }
+    uint64_t last = sectors * SECTOR_SIZE - 1;
+    if (last > std::numeric_limits<value_type>::max() - last_checked_ - 1) {
+      last = std::numeric_limits<value_type>::max();
+    } else {
+      last += first;
     }
+    auto start = std::chrono::steady_clock::now();
+    size_t capacity = data_.capacity();
+    std::vector<std::vector<value_type>> results(sectors);
+    const uint64_t workers = std::min<uint64_t>(threads, sectors);
+    std::atomic<uint64_t> next{0};
+    auto worker = [this, &results, &next, first, last, sectors]() {
+      WheelSieve sieve;
+      for (uint64_t claim; (claim = next.fetch_add(CLAIM_SECTORS)) < sectors;) {
+        for (uint64_t i = claim; i < claim + CLAIM_SECTORS && i < sectors;
+             ++i) {
+          uint64_t lo = first + i * SECTOR_SIZE;
+          uint64_t hi = lo + SECTOR_SIZE - 1;
+          if (hi > last) {
+            hi = last;
+          }
+          std::vector<value_type> &result = results[i];
+          sieve.sieve(lo, hi, SMALL_PRIMES.begin(), SMALL_PRIMES.end(),
+                      base_.data(), base_.data() + base_.size());
+          sieve.for_each_prime([&result](uint64_t prime) {
+            result.push_back(static_cast<value_type>(prime));
+          });
+        }
+      }
+    };
+    std::vector<std::thread> pool;
+    for (uint64_t i = 0; i < workers; ++i) {
+      pool.emplace_back(worker);
+    }
+    for (std::thread &thread : pool) {
+      thread.join();
+    }
+    for (std::vector<value_type> const &result : results) {
+      for (value_type prime : result) {
+        data_.push_back(prime);
+        if (is_base_prime<value_type>(prime)) {
+          base_.push_back(static_cast<uint32_t>(prime));
+        }
+      }
+    }
+    last_checked_ = static_cast<value_type>(last);
+    grows_ += data_.capacity() != capacity;
+    sieve_ns_ += elapsed_ns(start);
+    sectors_ += sectors;
   }
-  last_checked_ += tmp_size;
-#ifdef DEBUG_MODE
-  uint32_t end_size = static_cast<uint32_t>(data_.size());
-  auto end_time = std::chrono::high_resolution_clock::now();
-  auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(end_time -
-                                                                    start_time)
-                  .count();
-  std::cout << "Adding primes to PrimesCache finished in " << diff << "ms"
-            << '\n'
-            << end_size - start_size << " new elements\nlast==" << last_checked_
-            << std::endl;
-#endif
-}
-
-uint32_t PrimesCache::operator[](uint32_t pos) {
-  while (data_.size() <= pos && last_checked_ != UINT32_MAX) {
-    add_primes();
+}
+
+template <typename Storage>
+typename BasicPrimesCache<Storage>::value_type
+BasicPrimesCache<Storage>::operator[](value_type pos) {
+  if (data_.size() > pos) {
+    if (pos >= refill_at_.load(std::memory_order_relaxed)) {
+      request(pos);
+    }
+    hit();
+    return data_[pos];
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++misses_;
+  while (data_.size() <= pos &&
+         last_checked_ != std::numeric_limits<value_type>::max()) {
+    grow();
+  }
+  if (ahead_) {
+    demand_ = std::max<uint64_t>(demand_, pos);
+    wake_.notify_one();
   }
   if (data_.size() > pos) {
     return data_[pos];
   }
-#ifdef DEBUG_MODE
-  std::cout << "Out of bounds in PrimesCache: operator[](" << pos << ')'
-            << std::endl;
-#endif
   return 0;
 }
 
-uint32_t PrimesCache::operator()(uint32_t pos) const noexcept {
+template <typename Storage>
+typename BasicPrimesCache<Storage>::value_type
+BasicPrimesCache<Storage>::operator()(value_type pos) const noexcept {
   if (data_.size() > pos) {
+    hit();
     return data_[pos];
   }
-  uint32_t left = static_cast<uint32_t>(pos + 1 - data_.size());
-  uint32_t now = last_checked_;
-  while (left) {
-    bool is_prime = false;
-    while (!is_prime) {
-      if (++now == UINT32_MAX) {
-#ifdef DEBUG_MODE
-        std::cout << "Out of bounds in PrimesCache: operator()(" << pos << ')'
-                  << std::endl;
-#endif
-        return 0;
-      }
-      is_prime = true;
-      for (uint32_t pr : data_) {
-        if (now % pr == 0) {
-          is_prime = false;
-          break;
-        }
-      }
-      if (is_prime) {
-        for (uint32_t i = data_.back() + 2; i * i <= now && i < UINT32_MAX_SQRT;
-             i += 2) {
-          if (now % i == 0) {
-            is_prime = false;
-            break;
-          }
+  try {
+    return search(pos);
+  } catch (...) {
+    return 0;
+  }
+}
+
+template <typename Storage>
+typename BasicPrimesCache<Storage>::value_type
+BasicPrimesCache<Storage>::search(value_type pos) const {
+  const uint64_t max = std::numeric_limits<value_type>::max();
+  uint64_t n = static_cast<uint64_t>(pos) + 1;
+  uint64_t upper = nth_prime_upper(n);
+  if (upper > max) {
+    upper = max;
+  }
+  uint32_t root = integer_sqrt(upper);
+  std::vector<uint32_t> local;
+  uint64_t size;
+  uint64_t last_checked;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++transient_;
+    size = data_.size();
+    last_checked = last_checked_;
+    if (root >= SMALL_PRIMES_LIMIT && last_checked_ >= root) {
+      local.assign(base_.begin(),
+                   std::upper_bound(base_.begin(), base_.end(), root));
+    }
+  }
+  if (root >= SMALL_PRIMES_LIMIT && local.empty()) {
+    local = primes_up_to(root);
+    local.erase(local.begin(), local.begin() + SMALL_PRIMES_COUNT);
+  }
+  WheelSieve sieve;
+  uint64_t known = size;
+  uint64_t checked = last_checked;
+  uint64_t lower = nth_prime_lower(n) - 1;
+  if (lower > checked && lower - checked > SECTOR_SIZE && lower < upper) {
+    known = count_primes(lower);
+    checked = lower;
+    if (known >= n) {
+      known = size;
+      checked = last_checked;
+    }
+  }
+  while (checked < max) {
+    uint64_t step = upper > checked && upper - checked < SECTOR_SIZE
+                        ? upper - checked
+                        : SECTOR_SIZE;
+    uint64_t last = max - checked < step ? max : checked + step;
+    sieve.sieve(checked + 1, last, SMALL_PRIMES.begin(), SMALL_PRIMES.end(),
+                local.data(), local.data() + local.size());
+    uint64_t found = sieve.count();
+    if (known + found >= n) {
+      value_type result = 0;
+      sieve.for_each_prime([&known, &result, n](uint64_t prime) {
+        if (++known == n) {
+          result = static_cast<value_type>(prime);
         }
+      });
+      return result;
+    }
+    known += found;
+    checked = last;
+  }
+  return 0;
+}
+
+template <typename Storage>
+size_t BasicPrimesCache<Storage>::fetch(value_type pos, size_t count,
+                                        value_type *out) {
+  count = static_cast<size_t>(std::min<uint64_t>(count, UINT64_MAX - pos));
+  uint64_t end = static_cast<uint64_t>(pos) + count;
+  if (data_.size() < end) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++misses_;
+    while (data_.size() < end &&
+           last_checked_ != std::numeric_limits<value_type>::max()) {
+      grow();
+    }
+    if (ahead_) {
+      demand_ = std::max<uint64_t>(demand_, end - 1);
+      wake_.notify_one();
+    }
+  } else {
+    if (count && end - 1 >= refill_at_.load(std::memory_order_relaxed)) {
+      request(static_cast<value_type>(end - 1));
+    }
+    hit();
+  }
+  size_t size = data_.size();
+  if (pos >= size) {
+    return 0;
+  }
+  count = std::min(count, size - pos);
+  copy_values(data_, pos, count, out, 0);
+  return count;
+}
+
+template <typename Storage>
+bool BasicPrimesCache<Storage>::save(const char *path) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const uint32_t width = sizeof(value_type);
+  CacheFileHeader header{};
+  int fd = open(path, O_RDWR);
+  if (fd >= 0 && read_header(fd, header) && header.width == width &&
+      header.count <= data_.size() && header.last_checked <= last_checked_) {
+    bool result = write_values<value_type>(
+        fd, begin() + static_cast<std::ptrdiff_t>(header.count), end(),
+        sizeof(header) + header.count * width);
+    header.count = data_.size();
+    header.last_checked = last_checked_;
+    result = result && write_all(fd, &header, sizeof(header), 0);
+    return close(fd) == 0 && result;
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+  std::string tmp = std::string(path) + ".tmp";
+  fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+  std::memcpy(header.magic, CACHE_FILE_MAGIC, sizeof(header.magic));
+  header.version = CACHE_FILE_VERSION;
+  header.width = width;
+  header.count = data_.size();
+  header.last_checked = last_checked_;
+  bool result = write_all(fd, &header, sizeof(header), 0) &&
+                write_values<value_type>(fd, begin(), end(), sizeof(header));
+  result = close(fd) == 0 && result && rename(tmp.c_str(), path) == 0;
+  if (!result) {
+    unlink(tmp.c_str());
+  }
+  return result;
+}
+
+template <typename Storage>
+bool BasicPrimesCache<Storage>::load(const char *path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  CacheFileHeader header{};
+  bool result = read_header(fd, header) &&
+                header.width == sizeof(value_type) &&
+                header.count <= header.last_checked;
+  if (result && header.count > data_.size() &&
+      header.last_checked > last_checked_) {
+    result = load_values(data_, fd, static_cast<size_t>(header.count));
+    if (result) {
+      last_checked_ = static_cast<value_type>(header.last_checked);
+      uint32_t known = base_.empty() ? SMALL_PRIMES_LIMIT - 1 : base_.back();
+      for (const_iterator it = std::upper_bound(begin(), end(), known);
+           it != end() && is_base_prime<value_type>(*it); ++it) {
+        base_.push_back(static_cast<uint32_t>(*it));
       }
     }
-    --left;
   }
-  return now;
+  close(fd);
+  return result;
 }
 
-PrimesCache::const_iterator PrimesCache::begin() const noexcept {
+template <typename Storage>
+bool BasicPrimesCache<Storage>::prefetch(uint32_t sectors) {
+  if (!concurrent_storage<Storage>::value) {
+    return sectors == 0;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  bool running = ahead_ != 0;
+  ahead_ = sectors;
+  if (sectors == 0) {
+    refill_at_.store(UINT64_MAX, std::memory_order_relaxed);
+  }
+  lock.unlock();
+  wake_.notify_one();
+  if (sectors && !running) {
+    prefetcher_ = std::thread(&BasicPrimesCache::prefetch_loop, this);
+  } else if (!sectors && prefetcher_.joinable()) {
+    prefetcher_.join();
+  }
+  return true;
+}
+
+template <typename Storage>
+void BasicPrimesCache<Storage>::request(value_type pos) {
+  uint64_t mark = refill_at_.load(std::memory_order_relaxed);
+  if (pos < mark || !refill_at_.compare_exchange_strong(mark, UINT64_MAX)) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  demand_ = std::max<uint64_t>(demand_, pos);
+  wake_.notify_one();
+}
+
+template <typename Storage> void BasicPrimesCache<Storage>::prefetch_loop() {
+  const value_type max = std::numeric_limits<value_type>::max();
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (ahead_) {
+    uint64_t window = static_cast<uint64_t>(ahead_) * SECTOR_SIZE;
+    uint64_t size = data_.size();
+    if (last_checked_ != max &&
+        (demand_ >= size || last_checked_ - data_[demand_] < window)) {
+      grow();
+      lock.unlock();
+      std::this_thread::yield();
+      lock.lock();
+      continue;
+    }
+    refill_at_.store(demand_ < size ? demand_ + (size - demand_) / 2
+                                    : UINT64_MAX,
+                     std::memory_order_relaxed);
+    wake_.wait_for(lock, std::chrono::milliseconds(PREFETCH_POLL));
+  }
+}
+
+template <typename Storage>
+typename BasicPrimesCache<Storage>::const_iterator
+BasicPrimesCache<Storage>::begin() const noexcept {
   return data_.begin();
 }
 
-PrimesCache::const_iterator PrimesCache::end() const noexcept {
+template <typename Storage>
+typename BasicPrimesCache<Storage>::const_iterator
+BasicPrimesCache<Storage>::end() const noexcept {
   return data_.end();
 }
 
-uint32_t PrimesCache::last_checked() const noexcept { return last_checked_; }
+template <typename Storage>
+typename BasicPrimesCache<Storage>::value_type
+BasicPrimesCache<Storage>::last_checked() const noexcept {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return last_checked_;
+}
+
+template <typename Storage>
+typename BasicPrimesCache<Storage>::value_type
+BasicPrimesCache<Storage>::size() const noexcept {
+  return static_cast<value_type>(data_.size());
+}
 
-uint32_t PrimesCache::size() const noexcept {
-  return static_cast<uint32_t>(data_.size());
+template <typename Storage>
+PrimesCacheStats BasicPrimesCache<Storage>::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  PrimesCacheStats result{};
+  result.size = data_.size();
+  result.capacity = data_.capacity();
+  result.memory = storage_memory(data_) +
+                  base_.capacity() * sizeof(uint32_t) +
+                  sieve_.bitmap().capacity();
+  result.last_checked = last_checked_;
+  result.sectors = sectors_;
+  result.sieve_ns = sieve_ns_;
+  result.grows = grows_;
+  for (HitCounter const &counter : hits_) {
+    result.hits += counter.value.load(std::memory_order_relaxed);
+  }
+  result.misses = misses_;
+  result.transient = transient_;
+  return result;
 }
 
-Primes::Primes() : size_{0}, unbound_{true} {}
+template <typename Storage>
+void BasicPrimesCache<Storage>::hit() const noexcept {
+  HitSlot &slot = hit_slots[id_ % HIT_SLOTS];
+  if (slot.owner != id_) {
+    slot.counter = hit_counter();
+    if (!slot.counter) {
+      return;
+    }
+    slot.owner = id_;
+  }
+  slot.counter->store(slot.counter->load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+}
 
-Primes::Primes(uint32_t max_value) : size_{0}, unbound_{false} {
-  while (data_.last_checked() < max_value) {
-    data_.add_primes();
+template <typename Storage>
+std::atomic<uint64_t> *
+BasicPrimesCache<Storage>::hit_counter() const noexcept {
+  try {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::thread::id thread = std::this_thread::get_id();
+    for (HitCounter &counter : hits_) {
+      if (counter.thread == thread) {
+        return &counter.value;
+      }
+    }
+    hits_.emplace_back();
+    hits_.back().thread = thread;
+    return &hits_.back().value;
+  } catch (...) {
+    return nullptr;
   }
-  auto end = std::upper_bound(data_.begin(), data_.end(), max_value);
-  size_ = static_cast<uint32_t>(end - data_.begin());
 }
 
-uint32_t Primes::operator[](uint32_t pos) {
+template <typename Cache> Cache &BasicPrimes<Cache>::cache() {
+  static Cache data;
+  return data;
+}
+
+template <typename Cache>
+BasicPrimes<Cache>::BasicPrimes() : size_{0}, unbound_{true} {}
+
+template <typename Cache>
+BasicPrimes<Cache>::BasicPrimes(value_type max_value)
+    : size_{0}, unbound_{false} {
+  cache().fill(max_value);
+  auto end = std::upper_bound(cache().begin(), cache().end(), max_value);
+  size_ = static_cast<value_type>(end - cache().begin());
+}
+
+template <typename Cache>
+typename BasicPrimes<Cache>::value_type
+BasicPrimes<Cache>::operator[](value_type pos) {
   if (unbound_ || size_ > pos) {
-    return data_[pos];
+    return cache()[pos];
   }
-#ifdef DEBUG_MODE
-  std::cout << "Out of bounds in Primes: operator[](" << pos << ')'
-            << std::endl;
-#endif
   return 0;
 }
 
-uint32_t Primes::operator()(uint32_t pos) const noexcept {
+template <typename Cache>
+typename BasicPrimes<Cache>::value_type
+BasicPrimes<Cache>::operator()(value_type pos) const noexcept {
   if (unbound_ || size_ > pos) {
-    return data_(pos);
+    return cache()(pos);
   }
-#ifdef DEBUG_MODE
-  std::cout << "Out of bounds in Primes: operator()(" << pos << ')'
-            << std::endl;
-#endif
   return 0;
 }
 
-uint32_t Primes::size() const noexcept {
-  return unbound_ ? data_.size() : size_;
+template <typename Cache>
+typename BasicPrimes<Cache>::value_type
+BasicPrimes<Cache>::size() const noexcept {
+  return unbound_ ? cache().size() : size_;
 }
 
-Primes::Iterator::Iterator(Primes *owner, uint32_t pos, bool end_it) noexcept
-    : owner_{owner}, pos_{pos}, end_it_{end_it} {}
-
-Primes::Iterator Primes::begin() { return Iterator(this); }
-
-Primes::Iterator Primes::end() { return Iterator(this, size_, unbound_); }
-
-Primes::Iterator &
-Primes::Iterator::operator+=(Primes::Iterator::difference_type diff) noexcept {
-  if (diff < 0) {
-    pos_ -= static_cast<uint32_t>(-diff);
-  } else {
-    pos_ += static_cast<uint32_t>(diff);
+template <typename Cache>
+size_t BasicPrimes<Cache>::fetch(value_type pos, size_t count,
+                                 value_type *out) {
+  if (!unbound_) {
+    if (pos >= size_) {
+      return 0;
+    }
+    count = static_cast<size_t>(
+        std::min<uint64_t>(count, static_cast<uint64_t>(size_ - pos)));
   }
-  return *this;
+  return cache().fetch(pos, count, out);
 }
 
-Primes::Iterator &
-Primes::Iterator::operator-=(Primes::Iterator::difference_type diff) noexcept {
-  return *this += -diff;
+template <typename Cache> bool BasicPrimes<Cache>::save(const char *path) {
+  return cache().save(path);
 }
 
-Primes::Iterator operator+(const Primes::Iterator &it,
-                           Primes::Iterator::difference_type diff) noexcept {
-  return Primes::Iterator(it) += diff;
+template <typename Cache> bool BasicPrimes<Cache>::load(const char *path) {
+  return cache().load(path);
 }
 
-Primes::Iterator operator-(const Primes::Iterator &it,
-                           Primes::Iterator::difference_type diff) noexcept {
-  return Primes::Iterator(it) -= diff;
+template <typename Cache> bool BasicPrimes<Cache>::prefetch(uint32_t sectors) {
+  return cache().prefetch(sectors);
 }
 
-Primes::Iterator operator+(Primes::Iterator::difference_type diff,
-                           const Primes::Iterator &it) noexcept {
-  return it + diff;
+template <typename Cache> PrimesCacheStats BasicPrimes<Cache>::stats() {
+  return cache().stats();
 }
 
-Primes::Iterator::difference_type
-operator-(const Primes::Iterator &lhs, const Primes::Iterator &rhs) noexcept {
-  if (lhs.end_it_ && rhs.end_it_) {
-    return 0;
-  }
-  if (lhs.end_it_ || rhs.end_it_) {
-    return lhs.end_it_ ? INT32_MAX : INT32_MIN;
-  }
-  return lhs.pos_ >= rhs.pos_ ? static_cast<Primes::Iterator::difference_type>(
-                                    lhs.pos_ - rhs.pos_)
-                              : -static_cast<Primes::Iterator::difference_type>(
-                                    rhs.pos_ - lhs.pos_);
-}
+template <typename Cache>
+BasicPrimes<Cache>::Iterator::Iterator(BasicPrimes *owner, value_type pos,
+                                       bool end_it) noexcept
+    : owner_{owner}, pos_{pos}, end_it_{end_it} {}
 
-bool operator==(const Primes::Iterator &lhs,
-                const Primes::Iterator &rhs) noexcept {
-  return (lhs.end_it_ || rhs.end_it_) ? (lhs.end_it_ && rhs.end_it_)
-                                      : lhs.pos_ == rhs.pos_;
+template <typename Cache>
+typename BasicPrimes<Cache>::Iterator BasicPrimes<Cache>::begin() {
+  return Iterator(this);
 }
 
-bool operator!=(const Primes::Iterator &lhs,
-                const Primes::Iterator &rhs) noexcept {
-  return !(lhs == rhs);
+template <typename Cache>
+typename BasicPrimes<Cache>::Iterator BasicPrimes<Cache>::end() {
+  return Iterator(this, size_, unbound_);
 }
 
-bool operator<(const Primes::Iterator &lhs,
-               const Primes::Iterator &rhs) noexcept {
-  if (lhs.end_it_ && rhs.end_it_) {
-    return false;
-  }
-  if (lhs.end_it_ || rhs.end_it_) {
-    return rhs.end_it_;
+template <typename Cache>
+typename BasicPrimes<Cache>::Iterator &
+BasicPrimes<Cache>::Iterator::operator+=(difference_type diff) noexcept {
+  if (diff < 0) {
+    pos_ -= static_cast<value_type>(-diff);
+  } else {
+    pos_ += static_cast<value_type>(diff);
   }
-  return lhs.pos_ < rhs.pos_;
+  return *this;
 }
 
-bool operator>(const Primes::Iterator &lhs,
-               const Primes::Iterator &rhs) noexcept {
-  return rhs < lhs;
+template <typename Cache>
+typename BasicPrimes<Cache>::Iterator &
+BasicPrimes<Cache>::Iterator::operator-=(difference_type diff) noexcept {
+  return *this += -diff;
 }
 
-bool operator>=(const Primes::Iterator &lhs,
-                const Primes::Iterator &rhs) noexcept {
-  return !(lhs < rhs);
+template <typename Cache>
+typename BasicPrimes<Cache>::Iterator::difference_type
+BasicPrimes<Cache>::Iterator::distance(Iterator const &rhs) const noexcept {
+  if (end_it_ && rhs.end_it_) {
+    return 0;
+  }
+  if (end_it_ || rhs.end_it_) {
+    return end_it_ ? std::numeric_limits<difference_type>::max()
+                   : std::numeric_limits<difference_type>::min();
+  }
+  return pos_ >= rhs.pos_ ? static_cast<difference_type>(pos_ - rhs.pos_)
+                          : -static_cast<difference_type>(rhs.pos_ - pos_);
 }
 
-bool operator<=(const Primes::Iterator &lhs,
-                const Primes::Iterator &rhs) noexcept {
-  return !(lhs > rhs);
+template <typename Cache>
+bool BasicPrimes<Cache>::Iterator::less(Iterator const &rhs) const noexcept {
+  if (end_it_ && rhs.end_it_) {
+    return false;
+  }
+  if (end_it_ || rhs.end_it_) {
+    return rhs.end_it_;
+  }
+  return pos_ < rhs.pos_;
 }
 
-Primes::Iterator &Primes::Iterator::operator++() noexcept {
+template <typename Cache>
+typename BasicPrimes<Cache>::Iterator &
+BasicPrimes<Cache>::Iterator::operator++() noexcept {
   ++pos_;
   return *this;
 }
 
-Primes::Iterator Primes::Iterator::operator++(int) const noexcept {
+template <typename Cache>
+typename BasicPrimes<Cache>::Iterator
+BasicPrimes<Cache>::Iterator::operator++(int) const noexcept {
   Iterator tmp(*this);
   ++tmp.pos_;
   return tmp;
 }
 
-Primes::Iterator &Primes::Iterator::operator--() noexcept {
+template <typename Cache>
+typename BasicPrimes<Cache>::Iterator &
+BasicPrimes<Cache>::Iterator::operator--() noexcept {
   --pos_;
   return *this;
 }
 
-Primes::Iterator Primes::Iterator::operator--(int) const noexcept {
+template <typename Cache>
+typename BasicPrimes<Cache>::Iterator
+BasicPrimes<Cache>::Iterator::operator--(int) const noexcept {
   Iterator tmp(*this);
   --tmp.pos_;
   return tmp;
 }
 
-uint32_t Primes::Iterator::operator*() const {
+template <typename Cache>
+typename BasicPrimes<Cache>::value_type
+BasicPrimes<Cache>::Iterator::operator*() const {
   return end_it_ ? 0 : owner_->operator[](pos_);
 }
+
+template class BasicPrimesCache<ChunkedStorage>;
+template class BasicPrimesCache<GapStorage>;
+template class BasicPrimesCache<MappedStorage>;
+template class BasicPrimesCache<std::vector<uint32_t>>;
+template class BasicPrimes<PrimesCache>;
+template class BasicPrimes<CompactPrimesCache>;
+template class BasicPrimes<MappedPrimesCache>;
+template class BasicPrimes<BasicPrimesCache<std::vector<uint32_t>>>;
+template class BasicPrimesCache<BasicChunkedStorage<uint64_t>>;
+template class BasicPrimesCache<BasicGapStorage<uint64_t>>;
+template class BasicPrimesCache<BasicMappedStorage<uint64_t>>;
+template class BasicPrimesCache<std::vector<uint64_t>>;
+template class BasicPrimes<PrimesCache64>;
+template class BasicPrimes<CompactPrimesCache64>;
+template class BasicPrimes<MappedPrimesCache64>;
+template class BasicPrimes<BasicPrimesCache<std::vector<uint64_t>>>;
@@ -0,0 +1,135 @@
+#include "../include/primes_bitmap.h"
+#include "../include/wheel_sieve.h"
+
+#include <algorithm>
+#include <bitset>
+
+namespace {
+/**
+ * @brief Количество чисел, описываемых одним 64-битным словом карты.
+ */
+const uint64_t WORD_SPAN{8 * WHEEL_SIZE};
+/**
+ * @brief Количество слов в группе, для которой хранится количество простых
+ * чисел перед ней.
+ */
+const uint64_t RANK_BLOCK{8};
+/**
+ * @brief Шаг по номеру простого числа, с которым запоминается номер группы.
+ */
+const uint64_t SELECT_SAMPLE{4096};
+
+inline uint64_t popcount(uint64_t word) noexcept {
+  return std::bitset<64>(word).count();
+}
+} // namespace
+
+PrimesBitmap::PrimesBitmap(uint64_t max_value)
+    : words_(static_cast<size_t>(max_value / WORD_SPAN + 1), 0), ranks_{},
+      samples_{}, masks_(WORD_SPAN, 0), max_value_{max_value}, size_{0} {
+  uint8_t *bytes = reinterpret_cast<uint8_t *>(words_.data());
+  for_each_segment(0, max_value, [bytes](WheelSieve const &segment) {
+    uint8_t *out = bytes + segment.low() / WHEEL_SIZE;
+    for (uint8_t byte : segment.bitmap()) {
+      *out++ |= byte;
+    }
+  });
+  words_.resize(
+      (words_.size() + RANK_BLOCK - 1) / RANK_BLOCK * RANK_BLOCK, 0);
+  uint64_t total = 0;
+  for (size_t block = 0; block < words_.size(); block += RANK_BLOCK) {
+    ranks_.push_back(total);
+    for (size_t i = block; i < block + RANK_BLOCK; ++i) {
+      total += popcount(words_[i]);
+    }
+    while (samples_.size() * SELECT_SAMPLE < total) {
+      samples_.push_back(block / RANK_BLOCK);
+    }
+  }
+  ranks_.push_back(total);
+  for (uint64_t small : {UINT64_C(2), UINT64_C(3), UINT64_C(5)}) {
+    total += small <= max_value;
+  }
+  size_ = total;
+  for (uint32_t rest = 0; rest < WORD_SPAN; ++rest) {
+    for (uint32_t bit = 0; bit < 64; ++bit) {
+      if ((bit / 8) * WHEEL_SIZE + WHEEL_RESIDUES[bit % 8] <= rest) {
+        masks_[rest] |= UINT64_C(1) << bit;
+      }
+    }
+  }
+}
+
+bool PrimesBitmap::is_prime(uint64_t value) const noexcept {
+  if (value > max_value_) {
+    return false;
+  }
+  if (value < 7) {
+    return value == 2 || value == 3 || value == 5;
+  }
+  uint8_t bit = WHEEL_INDEX[value % WHEEL_SIZE];
+  return bit < 8 && ((words_[value / WORD_SPAN] >>
+                      (value % WORD_SPAN / WHEEL_SIZE * 8 + bit)) &
+                     1);
+}
+
+uint64_t PrimesBitmap::pi(uint64_t value) const noexcept {
+  static const uint8_t small[7]{0, 0, 1, 2, 2, 3, 3};
+  if (value > max_value_) {
+    value = max_value_;
+  }
+  if (value < 7) {
+    return small[value];
+  }
+  uint64_t word = value / WORD_SPAN;
+  uint64_t first = word - word % RANK_BLOCK;
+  uint64_t result = 3 + ranks_[first / RANK_BLOCK];
+  for (uint64_t i = first; i < word; ++i) {
+    result += popcount(words_[i]);
+  }
+  return result + popcount(words_[word] & masks_[value % WORD_SPAN]);
+}
+
+uint64_t PrimesBitmap::operator[](uint64_t pos) const noexcept {
+  static const uint64_t small[3]{2, 3, 5};
+  if (pos >= size_) {
+    return 0;
+  }
+  if (pos < 3) {
+    return small[pos];
+  }
+  uint64_t rest = pos - 3;
+  uint64_t sample = rest / SELECT_SAMPLE;
+  auto lo = ranks_.begin() + static_cast<std::ptrdiff_t>(samples_[sample]);
+  auto hi = sample + 1 < samples_.size()
+                ? ranks_.begin() +
+                      static_cast<std::ptrdiff_t>(samples_[sample + 1] + 1)
+                : ranks_.end();
+  uint64_t block = static_cast<uint64_t>(
+      std::upper_bound(lo, hi, rest) - ranks_.begin() - 1);
+  rest -= ranks_[block];
+  uint64_t word = block * RANK_BLOCK;
+  for (uint64_t count = popcount(words_[word]); rest >= count;
+       count = popcount(words_[++word])) {
+    rest -= count;
+  }
+  uint64_t bits = words_[word];
+  for (; rest; --rest) {
+    bits &= bits - 1;
+  }
+  uint64_t bit = popcount((bits & (~bits + 1)) - 1);
+  return word * WORD_SPAN + bit / 8 * WHEEL_SIZE + WHEEL_RESIDUES[bit % 8];
+}
+
+uint64_t PrimesBitmap::size() const noexcept { return size_; }
+
+uint64_t PrimesBitmap::max_value() const noexcept { return max_value_; }
+
+const std::vector<uint64_t> &PrimesBitmap::words() const noexcept {
+  return words_;
+}
+
+size_t PrimesBitmap::memory() const noexcept {
+  return words_.size() * sizeof(uint64_t) + ranks_.size() * sizeof(uint64_t) +
+         samples_.size() * sizeof(uint64_t) + masks_.size() * sizeof(uint64_t);
+}
@@ -0,0 +1,208 @@
+#include "../include/primes_index.h"
+#include "../include/primes.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace {
+/**
+ * @brief Сигнатура файла индекса.
+ */
+const char INDEX_FILE_MAGIC[8]{"PRIMESI"};
+
+/**
+ * @brief Заголовок файла индекса, за которым следуют контрольные точки.
+ */
+struct IndexFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t width;
+  uint64_t step;
+  uint64_t max_value;
+  uint64_t size;
+};
+
+/**
+ * @return Количество контрольных точек для size простых чисел с шагом step.
+ */
+uint64_t checkpoint_count(uint64_t size, uint64_t step) noexcept {
+  return size ? (size - 1) / step + 1 : 0;
+}
+} // namespace
+
+template <typename T>
+BasicPrimesIndex<T>::BasicPrimesIndex() noexcept
+    : checkpoints_{}, base_{}, max_value_{0}, size_{0}, step_{INDEX_STEP} {}
+
+template <typename T>
+BasicPrimesIndex<T>::BasicPrimesIndex(T max_value, uint32_t step)
+    : checkpoints_{}, base_{primes_up_to(integer_sqrt(max_value))},
+      max_value_{max_value}, size_{0}, step_{step ? step : 1} {
+  for_each_segment(0, max_value, [this](WheelSieve const &segment) {
+    uint64_t found = segment.count();
+    if (size_ + found > checkpoints_.size() * static_cast<uint64_t>(step_)) {
+      uint64_t pos = size_;
+      segment.for_each_prime([this, &pos](uint64_t prime) {
+        if (pos++ % step_ == 0) {
+          checkpoints_.push_back(static_cast<T>(prime));
+        }
+      });
+    }
+    size_ = static_cast<T>(size_ + found);
+  });
+}
+
+template <typename T>
+template <typename F>
+void BasicPrimesIndex<T>::sieve(uint64_t lo, uint64_t hi, F f) const {
+  WheelSieve sieve;
+  for (uint64_t first = lo; first <= hi; first += SECTOR_SIZE) {
+    uint64_t last = hi - first < SECTOR_SIZE ? hi : first + SECTOR_SIZE - 1;
+    sieve.sieve(first, last, base_.data(), base_.data() + base_.size());
+    if (!f(static_cast<WheelSieve const &>(sieve)) || last == hi) {
+      break;
+    }
+  }
+}
+
+template <typename T> T BasicPrimesIndex<T>::operator[](T pos) const {
+  if (pos >= size_) {
+    return 0;
+  }
+  size_t k = static_cast<size_t>(pos / step_);
+  uint64_t known = static_cast<uint64_t>(k) * step_;
+  if (known == pos) {
+    return checkpoints_[k];
+  }
+  uint64_t hi = k + 1 < checkpoints_.size()
+                    ? static_cast<uint64_t>(checkpoints_[k + 1]) - 1
+                    : max_value_;
+  T result = 0;
+  sieve(static_cast<uint64_t>(checkpoints_[k]) + 1, hi,
+        [&known, &result, pos](WheelSieve const &segment) {
+          uint64_t found = segment.count();
+          if (known + found < pos) {
+            known += found;
+            return true;
+          }
+          segment.for_each_prime([&known, &result, pos](uint64_t prime) {
+            if (++known == pos) {
+              result = static_cast<T>(prime);
+            }
+          });
+          return false;
+        });
+  return result;
+}
+
+template <typename T> T BasicPrimesIndex<T>::count(T value) const {
+  if (checkpoints_.empty() || value < checkpoints_.front()) {
+    return 0;
+  }
+  if (value >= max_value_) {
+    return size_;
+  }
+  size_t k = static_cast<size_t>(
+      std::upper_bound(checkpoints_.begin(), checkpoints_.end(), value) -
+      checkpoints_.begin() - 1);
+  uint64_t result = static_cast<uint64_t>(k) * step_ + 1;
+  if (checkpoints_[k] < value) {
+    sieve(static_cast<uint64_t>(checkpoints_[k]) + 1, value,
+          [&result](WheelSieve const &segment) {
+            result += segment.count();
+            return true;
+          });
+  }
+  return static_cast<T>(result);
+}
+
+template <typename T> T BasicPrimesIndex<T>::size() const noexcept {
+  return size_;
+}
+
+template <typename T> T BasicPrimesIndex<T>::max_value() const noexcept {
+  return max_value_;
+}
+
+template <typename T> uint32_t BasicPrimesIndex<T>::step() const noexcept {
+  return step_;
+}
+
+template <typename T> size_t BasicPrimesIndex<T>::memory() const noexcept {
+  return checkpoints_.capacity() * sizeof(T) +
+         base_.capacity() * sizeof(uint32_t);
+}
+
+template <typename T> bool BasicPrimesIndex<T>::save(const char *path) const {
+  std::FILE *file = std::fopen(path, "wb");
+  if (!file) {
+    return false;
+  }
+  IndexFileHeader header{};
+  std::memcpy(header.magic, INDEX_FILE_MAGIC, sizeof(header.magic));
+  header.version = INDEX_FILE_VERSION;
+  header.width = sizeof(T);
+  header.step = step_;
+  header.max_value = max_value_;
+  header.size = size_;
+  bool result =
+      std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+      std::fwrite(checkpoints_.data(), sizeof(T), checkpoints_.size(),
+                  file) == checkpoints_.size();
+  return std::fclose(file) == 0 && result;
+}
+
+template <typename T> bool BasicPrimesIndex<T>::load(const char *path) {
+  std::FILE *file = std::fopen(path, "rb");
+  if (!file) {
+    return false;
+  }
+  IndexFileHeader header{};
+  bool result =
+      std::fread(&header, sizeof(header), 1, file) == 1 &&
+      std::memcmp(header.magic, INDEX_FILE_MAGIC, sizeof(header.magic)) ==
+          0 &&
+      header.version == INDEX_FILE_VERSION && header.width == sizeof(T) &&
+      header.step > 0 && header.step <= UINT32_MAX &&
+      header.max_value <= std::numeric_limits<T>::max() &&
+      header.size <= header.max_value;
+  uint64_t count = result ? checkpoint_count(header.size, header.step) : 0;
+  if (result) {
+    long end = std::fseek(file, 0, SEEK_END) == 0 ? std::ftell(file) : -1;
+    uint64_t bytes = static_cast<uint64_t>(end) - sizeof(header);
+    result = end >= 0 && bytes % sizeof(T) == 0 &&
+             bytes / sizeof(T) == count &&
+             std::fseek(file, sizeof(header), SEEK_SET) == 0;
+  }
+  std::vector<T> checkpoints;
+  if (result) {
+    try {
+      checkpoints.resize(static_cast<size_t>(count));
+    } catch (...) {
+      result = false;
+    }
+  }
+  if (result) {
+    result = std::fread(checkpoints.data(), sizeof(T), checkpoints.size(),
+                        file) == checkpoints.size();
+  }
+  std::fclose(file);
+  for (size_t i = 1; result && i < checkpoints.size(); ++i) {
+    result = checkpoints[i - 1] < checkpoints[i];
+  }
+  if (!result ||
+      (!checkpoints.empty() && checkpoints.back() > header.max_value)) {
+    return false;
+  }
+  checkpoints_.swap(checkpoints);
+  base_ = primes_up_to(integer_sqrt(header.max_value));
+  max_value_ = static_cast<T>(header.max_value);
+  size_ = static_cast<T>(header.size);
+  step_ = static_cast<uint32_t>(header.step);
+  return true;
+}
+
+template class BasicPrimesIndex<uint32_t>;
+template class BasicPrimesIndex<uint64_t>;
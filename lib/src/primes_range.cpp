@@ -0,0 +1,53 @@
+#include "../include/primes_range.h"
+#include "../include/primes.h"
+
+template <typename T>
+BasicPrimesRange<T>::BasicPrimesRange(T lo, T hi)
+    : data_{}, low_{lo}, high_{hi} {
+  if (lo > hi) {
+    return;
+  }
+  std::vector<uint32_t> base = primes_up_to(integer_sqrt(hi));
+  WheelSieve sieve;
+  for (uint64_t first = lo; first <= hi; first += SECTOR_SIZE) {
+    uint64_t last = hi - first < SECTOR_SIZE ? hi : first + SECTOR_SIZE - 1;
+    sieve.sieve(first, last, base.data(), base.data() + base.size());
+    sieve.for_each_prime([this](uint64_t prime) {
+      data_.push_back(static_cast<T>(prime));
+    });
+    if (last == hi) {
+      break;
+    }
+  }
+}
+
+template <typename T> T BasicPrimesRange<T>::operator[](T pos) const noexcept {
+  return pos < data_.size() ? data_[pos] : 0;
+}
+
+template <typename T>
+typename BasicPrimesRange<T>::const_iterator
+BasicPrimesRange<T>::begin() const noexcept {
+  return data_.begin();
+}
+
+template <typename T>
+typename BasicPrimesRange<T>::const_iterator
+BasicPrimesRange<T>::end() const noexcept {
+  return data_.end();
+}
+
+template <typename T> T BasicPrimesRange<T>::size() const noexcept {
+  return static_cast<T>(data_.size());
+}
+
+template <typename T> T BasicPrimesRange<T>::low() const noexcept {
+  return low_;
+}
+
+template <typename T> T BasicPrimesRange<T>::high() const noexcept {
+  return high_;
+}
+
+template class BasicPrimesRange<uint32_t>;
+template class BasicPrimesRange<uint64_t>;
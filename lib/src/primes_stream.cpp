@@ -0,0 +1,101 @@
+#include "../include/primes_stream.h"
+#include "../include/primes.h"
+
+#include <limits>
+
+template <typename T>
+BasicPrimesStream<T>::BasicPrimesStream(size_t budget)
+    : window_{}, base_{}, sieve_{},
+      limit_{budget / sizeof(T)}, first_{0}, next_{0}, done_{false} {}
+
+template <typename T> T BasicPrimesStream<T>::operator[](T pos) {
+  if (pos < first_) {
+    return 0;
+  }
+  while (pos - first_ >= window_.size()) {
+    if (!grow()) {
+      return 0;
+    }
+    while (window_.size() > limit_ && first_ < pos) {
+      window_.pop_front();
+      ++first_;
+    }
+  }
+  return window_[pos - first_];
+}
+
+template <typename T> bool BasicPrimesStream<T>::grow() {
+  const uint64_t max = std::numeric_limits<T>::max();
+  const uint64_t max_sqrt = UINT64_C(1)
+                            << (std::numeric_limits<T>::digits / 2);
+  if (done_) {
+    return false;
+  }
+  uint64_t last = max - next_ < SECTOR_SIZE ? max : next_ + SECTOR_SIZE - 1;
+  sieve_.sieve(next_, last, SMALL_PRIMES.begin(), SMALL_PRIMES.end(),
+               base_.data(), base_.data() + base_.size());
+  sieve_.for_each_prime([this, max_sqrt](uint64_t prime) {
+    window_.push_back(static_cast<T>(prime));
+    if (prime >= SMALL_PRIMES_LIMIT && prime < max_sqrt) {
+      base_.push_back(static_cast<uint32_t>(prime));
+    }
+  });
+  done_ = last == max;
+  next_ = last + 1;
+  return true;
+}
+
+template <typename T> T BasicPrimesStream<T>::first() const noexcept {
+  return first_;
+}
+
+template <typename T> T BasicPrimesStream<T>::size() const noexcept {
+  return static_cast<T>(first_ + window_.size());
+}
+
+template <typename T> size_t BasicPrimesStream<T>::memory() const noexcept {
+  return window_.size() * sizeof(T) + base_.capacity() * sizeof(uint32_t) +
+         sieve_.bitmap().capacity();
+}
+
+template <typename T>
+BasicPrimesStream<T>::Iterator::Iterator(BasicPrimesStream *owner, T pos,
+                                         bool end_it) noexcept
+    : owner_{owner}, pos_{pos}, end_it_{end_it} {}
+
+template <typename T>
+typename BasicPrimesStream<T>::Iterator &
+BasicPrimesStream<T>::Iterator::operator++() noexcept {
+  ++pos_;
+  return *this;
+}
+
+template <typename T>
+typename BasicPrimesStream<T>::Iterator
+BasicPrimesStream<T>::Iterator::operator++(int) noexcept {
+  Iterator tmp(*this);
+  ++pos_;
+  return tmp;
+}
+
+template <typename T> T BasicPrimesStream<T>::Iterator::operator*() const {
+  return (*owner_)[pos_];
+}
+
+template <typename T> bool BasicPrimesStream<T>::Iterator::exhausted() const {
+  return end_it_ || (*owner_)[pos_] == 0;
+}
+
+template <typename T>
+typename BasicPrimesStream<T>::Iterator
+BasicPrimesStream<T>::begin() noexcept {
+  return Iterator(this, first_, false);
+}
+
+template <typename T>
+typename BasicPrimesStream<T>::Iterator BasicPrimesStream<T>::end() noexcept {
+  return Iterator(this, 0, true);
+}
+
+template class BasicPrimesStream<uint32_t>;
+template class BasicPrimesStream<uint64_t>;
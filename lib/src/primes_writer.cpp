@@ -0,0 +1,67 @@
+#include "../include/primes_writer.h"
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+/**
+ * @brief Десятичная запись чисел от 00 до 99.
+ */
+const char DIGIT_PAIRS[201]{"00010203040506070809"
+                            "10111213141516171819"
+                            "20212223242526272829"
+                            "30313233343536373839"
+                            "40414243444546474849"
+                            "50515253545556575859"
+                            "60616263646566676869"
+                            "70717273747576777879"
+                            "80818283848586878889"
+                            "90919293949596979899"};
+} // namespace
+
+char *format_decimal(uint64_t value, char *out) noexcept {
+  char digits[DECIMAL_DIGITS];
+  char *begin = digits + DECIMAL_DIGITS;
+  while (value >= 100) {
+    size_t pair = static_cast<size_t>(value % 100) * 2;
+    value /= 100;
+    *--begin = DIGIT_PAIRS[pair + 1];
+    *--begin = DIGIT_PAIRS[pair];
+  }
+  if (value >= 10) {
+    *--begin = DIGIT_PAIRS[value * 2 + 1];
+    *--begin = DIGIT_PAIRS[value * 2];
+  } else {
+    *--begin = static_cast<char>('0' + value);
+  }
+  size_t length = static_cast<size_t>(digits + DECIMAL_DIGITS - begin);
+  std::memcpy(out, begin, length);
+  return out + length;
+}
+
+PrimesWriter::PrimesWriter(int fd, char separator)
+    : buffer_(WRITER_BUFFER), used_{0}, count_{0}, fd_{fd},
+      separator_{separator} {}
+
+PrimesWriter::~PrimesWriter() { flush(); }
+
+bool PrimesWriter::flush() {
+  const char *data = buffer_.data();
+  size_t left = used_;
+  used_ = 0;
+  while (left) {
+    ssize_t written = ::write(fd_, data, left);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    left -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+uint64_t PrimesWriter::count() const noexcept { return count_; }
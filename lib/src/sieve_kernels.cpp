@@ -0,0 +1,231 @@
+#include "../include/sieve_kernels.h"
+#include "../include/wheel_sieve.h"
+
+#include <bitset>
+#include <cstring>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SIEVE_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+/**
+ * @brief Смещения чисел от начала 64-битного слова карты: бит k слова
+ * соответствует числу WHEEL_SIZE * (k / 8) + WHEEL_RESIDUES[k % 8].
+ */
+struct WordOffsets {
+  uint64_t offsets[64];
+
+  WordOffsets() noexcept {
+    for (uint32_t bit = 0; bit < 64; ++bit) {
+      offsets[bit] = bit / 8 * WHEEL_SIZE + WHEEL_RESIDUES[bit % 8];
+    }
+  }
+};
+
+/**
+ * @brief Для каждого значения байта карты - остатки установленных битов в
+ * порядке возрастания, дополненные нулями до 8, и их количество.
+ */
+struct ByteResidues {
+  uint8_t residues[256][8];
+  uint8_t sizes[256];
+
+  ByteResidues() noexcept : residues{}, sizes{} {
+    for (uint32_t byte = 0; byte < 256; ++byte) {
+      for (uint32_t bit = 0; bit < 8; ++bit) {
+        if (byte & (1u << bit)) {
+          residues[byte][sizes[byte]++] = WHEEL_RESIDUES[bit];
+        }
+      }
+    }
+  }
+};
+
+const WordOffsets &word_offsets() noexcept {
+  static const WordOffsets table;
+  return table;
+}
+
+const ByteResidues &byte_residues() noexcept {
+  static const ByteResidues table;
+  return table;
+}
+
+/**
+ * @param data
+ * @param bytes
+ * @return Не более 8 байт data, дополненные нулями до 64-битного слова.
+ */
+inline uint64_t load_word(const uint8_t *data, size_t bytes) noexcept {
+  uint64_t word = 0;
+  std::memcpy(&word, data, bytes < sizeof(word) ? bytes : sizeof(word));
+  return word;
+}
+
+uint64_t count_scalar(const uint8_t *data, size_t bytes) {
+  uint64_t result = 0;
+  for (size_t i = 0; i < bytes; i += sizeof(uint64_t)) {
+    result += std::bitset<64>(load_word(data + i, bytes - i)).count();
+  }
+  return result;
+}
+
+size_t decode_scalar(const uint8_t *data, size_t bytes, uint64_t base,
+                     uint64_t *out) {
+  ByteResidues const &table = byte_residues();
+  uint64_t *begin = out;
+  for (size_t i = 0; i < bytes; ++i, base += WHEEL_SIZE) {
+    const uint8_t *residues = table.residues[data[i]];
+    for (uint32_t k = 0; k < 8; ++k) {
+      out[k] = base + residues[k];
+    }
+    out += table.sizes[data[i]];
+  }
+  return static_cast<size_t>(out - begin);
+}
+
+#ifdef SIEVE_KERNELS_X86
+__attribute__((target("popcnt"))) uint64_t count_popcnt(const uint8_t *data,
+                                                        size_t bytes) {
+  uint64_t result = 0;
+  for (size_t i = 0; i < bytes; i += sizeof(uint64_t)) {
+    result += static_cast<uint64_t>(
+        __builtin_popcountll(load_word(data + i, bytes - i)));
+  }
+  return result;
+}
+
+__attribute__((target("popcnt,bmi"))) size_t
+decode_popcnt(const uint8_t *data, size_t bytes, uint64_t base,
+              uint64_t *out) {
+  const uint64_t *offsets = word_offsets().offsets;
+  uint64_t *begin = out;
+  for (size_t i = 0; i < bytes;
+       i += sizeof(uint64_t), base += 8 * WHEEL_SIZE) {
+    for (uint64_t word = load_word(data + i, bytes - i); word;
+         word &= word - 1) {
+      *out++ = base + offsets[__builtin_ctzll(word)];
+    }
+  }
+  return static_cast<size_t>(out - begin);
+}
+
+__attribute__((target("avx2,popcnt"))) uint64_t count_avx2(const uint8_t *data,
+                                                           size_t bytes) {
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1,
+                       2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low = _mm256_set1_epi8(0x0F);
+  __m256i total = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + sizeof(__m256i) <= bytes; i += sizeof(__m256i)) {
+    __m256i chunk =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(chunk, 4), low);
+    __m256i counts = _mm256_add_epi8(
+        _mm256_shuffle_epi8(lookup, _mm256_and_si256(chunk, low)),
+        _mm256_shuffle_epi8(lookup, high));
+    total = _mm256_add_epi64(total,
+                             _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+  }
+  uint64_t lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), total);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+         count_popcnt(data + i, bytes - i);
+}
+
+__attribute__((target("avx2,popcnt"))) size_t
+decode_avx2(const uint8_t *data, size_t bytes, uint64_t base, uint64_t *out) {
+  const uint8_t(*residues)[8] = byte_residues().residues;
+  uint64_t *begin = out;
+  __m256i value = _mm256_set1_epi64x(static_cast<long long>(base));
+  const __m256i step = _mm256_set1_epi64x(WHEEL_SIZE);
+  for (size_t i = 0; i < bytes; ++i) {
+    __m128i packed = _mm_loadl_epi64(
+        reinterpret_cast<const __m128i *>(residues[data[i]]));
+    __m256i low = _mm256_cvtepu8_epi64(packed);
+    __m256i high = _mm256_cvtepu8_epi64(_mm_srli_si128(packed, 4));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out),
+                        _mm256_add_epi64(value, low));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 4),
+                        _mm256_add_epi64(value, high));
+    out += __builtin_popcount(data[i]);
+    value = _mm256_add_epi64(value, step);
+  }
+  return static_cast<size_t>(out - begin);
+}
+
+__attribute__((target("avx512f,avx512bw,avx2,popcnt"))) uint64_t
+count_avx512(const uint8_t *data, size_t bytes) {
+  static const uint8_t nibbles[64]{
+      0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2,
+      2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3,
+      2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+  const __m512i lookup = _mm512_loadu_si512(nibbles);
+  const __m512i low = _mm512_set1_epi8(0x0F);
+  __m512i total = _mm512_setzero_si512();
+  size_t i = 0;
+  for (; i + sizeof(__m512i) <= bytes; i += sizeof(__m512i)) {
+    __m512i chunk = _mm512_loadu_si512(data + i);
+    __m512i high = _mm512_and_si512(_mm512_srli_epi16(chunk, 4), low);
+    __m512i counts = _mm512_add_epi8(
+        _mm512_shuffle_epi8(lookup, _mm512_and_si512(chunk, low)),
+        _mm512_shuffle_epi8(lookup, high));
+    total = _mm512_add_epi64(total,
+                             _mm512_sad_epu8(counts, _mm512_setzero_si512()));
+  }
+  __m256i half =
+      _mm256_add_epi64(_mm512_maskz_extracti64x4_epi64(0xF, total, 0),
+                       _mm512_maskz_extracti64x4_epi64(0xF, total, 1));
+  __m128i quarter = _mm_add_epi64(_mm256_castsi256_si128(half),
+                                  _mm256_extracti128_si256(half, 1));
+  return static_cast<uint64_t>(_mm_cvtsi128_si64(quarter)) +
+         static_cast<uint64_t>(_mm_extract_epi64(quarter, 1)) +
+         count_popcnt(data + i, bytes - i);
+}
+
+__attribute__((target("avx512f,popcnt"))) size_t
+decode_avx512(const uint8_t *data, size_t bytes, uint64_t base,
+              uint64_t *out) {
+  uint64_t *begin = out;
+  __m512i value = _mm512_add_epi64(
+      _mm512_set1_epi64(static_cast<long long>(base)),
+      _mm512_setr_epi64(WHEEL_RESIDUES[0], WHEEL_RESIDUES[1], WHEEL_RESIDUES[2],
+                        WHEEL_RESIDUES[3], WHEEL_RESIDUES[4], WHEEL_RESIDUES[5],
+                        WHEEL_RESIDUES[6], WHEEL_RESIDUES[7]));
+  const __m512i step = _mm512_set1_epi64(WHEEL_SIZE);
+  for (size_t i = 0; i < bytes; ++i) {
+    _mm512_storeu_si512(out, _mm512_maskz_compress_epi64(data[i], value));
+    out += __builtin_popcount(data[i]);
+    value = _mm512_add_epi64(value, step);
+  }
+  return static_cast<size_t>(out - begin);
+}
+#endif
+} // namespace
+
+std::vector<SieveKernels> supported_sieve_kernels() {
+  std::vector<SieveKernels> result{{"scalar", count_scalar, decode_scalar}};
+#ifdef SIEVE_KERNELS_X86
+  __builtin_cpu_init();
+  if (!__builtin_cpu_supports("popcnt") || !__builtin_cpu_supports("bmi")) {
+    return result;
+  }
+  result.push_back({"popcnt", count_popcnt, decode_popcnt});
+  if (!__builtin_cpu_supports("avx2")) {
+    return result;
+  }
+  result.push_back({"avx2", count_avx2, decode_avx2});
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+    result.push_back({"avx512", count_avx512, decode_avx512});
+  }
+#endif
+  return result;
+}
+
+const SieveKernels &sieve_kernels() noexcept {
+  static const SieveKernels kernels = supported_sieve_kernels().back();
+  return kernels;
+}
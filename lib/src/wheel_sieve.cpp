@@ -0,0 +1,319 @@
+#include "../include/wheel_sieve.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <unistd.h>
+
+namespace {
+/**
+ * @brief Размер кэша данных первого уровня, если его не удалось определить.
+ */
+const size_t DEFAULT_L1_CACHE{32768};
+/**
+ * @brief Размер кэша второго уровня, если его не удалось определить.
+ */
+const size_t DEFAULT_L2_CACHE{262144};
+/**
+ * @brief Простые числа, кратные которых уже вычеркнуты в \link
+ * presieve_pattern() \endlink.
+ */
+const uint32_t PRESIEVE_PRIMES[]{7, 11, 13, 17, 19};
+/**
+ * @brief Период \link presieve_pattern() \endlink в байтах решета:
+ * произведение \link PRESIEVE_PRIMES \endlink.
+ */
+const size_t PRESIEVE_PERIOD{7 * 11 * 13 * 17 * 19};
+/**
+ * @brief Биты байта 0 решета, соответствующие самим \link PRESIEVE_PRIMES
+ * \endlink.
+ */
+const uint8_t PRESIEVE_SELF{0x3E};
+
+/**
+ * @param level
+ * @return Размер кэша данных уровня level (1 или 2) в байтах.
+ */
+size_t cache_size(int level) noexcept {
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+  long size =
+      sysconf(level == 1 ? _SC_LEVEL1_DCACHE_SIZE : _SC_LEVEL2_CACHE_SIZE);
+  if (size > 0) {
+    return static_cast<size_t>(size);
+  }
+#endif
+  return level == 1 ? DEFAULT_L1_CACHE : DEFAULT_L2_CACHE;
+}
+
+/**
+ * @return Байты решета с номерами [0, PRESIEVE_PERIOD), в которых вычеркнуты
+ * все числа, кратные \link PRESIEVE_PRIMES \endlink, включая их самих. Байт
+ * i подходит для любого байта с номером, сравнимым с i по модулю
+ * PRESIEVE_PERIOD.
+ */
+const std::vector<uint8_t> &presieve_pattern() {
+  static const std::vector<uint8_t> pattern = [] {
+    std::vector<uint8_t> result(PRESIEVE_PERIOD, UINT8_C(0xFF));
+    for (uint32_t prime : PRESIEVE_PRIMES) {
+      for (uint8_t residue : WHEEL_RESIDUES) {
+        const uint8_t mask = static_cast<uint8_t>(
+            ~(1u << WHEEL_INDEX[prime * residue % WHEEL_SIZE]));
+        for (size_t i = prime * residue / WHEEL_SIZE; i < PRESIEVE_PERIOD;
+             i += prime) {
+          result[i] &= mask;
+        }
+      }
+    }
+    return result;
+  }();
+  return pattern;
+}
+
+/**
+ * @brief Заполняет bytes байт решета, начиная с байта с номером first,
+ * копиями \link presieve_pattern() \endlink.
+ * @param data
+ * @param first
+ * @param bytes
+ */
+void fill_presieved(uint8_t *data, uint64_t first, size_t bytes) {
+  const uint8_t *pattern = presieve_pattern().data();
+  size_t offset = static_cast<size_t>(first % PRESIEVE_PERIOD);
+  while (bytes) {
+    size_t chunk = std::min(bytes, PRESIEVE_PERIOD - offset);
+    std::memcpy(data, pattern + offset, chunk);
+    data += chunk;
+    bytes -= chunk;
+    offset = 0;
+  }
+}
+} // namespace
+
+WheelSieve::WheelSieve() noexcept
+    : data_{}, base_{0}, low_{1}, high_{0}, small_{}, buckets_{}, spare_{},
+      active_{0}, last_prime_{0} {}
+
+void WheelSieve::sieve(uint64_t lo, uint64_t hi, const uint32_t *primes_begin,
+                       const uint32_t *primes_end) {
+  sieve(lo, hi, primes_begin, primes_end, primes_end, primes_end);
+}
+
+void WheelSieve::sieve(uint64_t lo, uint64_t hi, const uint32_t *primes_begin,
+                       const uint32_t *primes_end, const uint32_t *more_begin,
+                       const uint32_t *more_end) {
+  size_t head = static_cast<size_t>(primes_end - primes_begin);
+  size_t count = head + static_cast<size_t>(more_end - more_begin);
+  bool resume =
+      low_ <= high_ && high_ != UINT64_MAX && lo == high_ + 1 &&
+      active_ <= count &&
+      (active_ == 0 || (active_ <= head ? primes_begin[active_ - 1]
+                                        : more_begin[active_ - 1 - head]) ==
+                           last_prime_);
+  low_ = lo;
+  high_ = hi;
+  base_ = lo - lo % WHEEL_SIZE;
+  if (lo > hi) {
+    data_.clear();
+    reset();
+    return;
+  }
+  if (!resume) {
+    reset();
+  }
+  size_t bytes = static_cast<size_t>((hi - base_) / WHEEL_SIZE + 1);
+  data_.resize(bytes);
+  fill_presieved(data_.data(), base_ / WHEEL_SIZE, bytes);
+  if (base_ == 0) {
+    data_.front() |= PRESIEVE_SELF;
+  }
+  for (uint32_t bit = 0; bit < 8; ++bit) {
+    if (base_ + WHEEL_RESIDUES[bit] < lo) {
+      data_.front() &= static_cast<uint8_t>(~(1u << bit));
+    }
+    if (hi - (base_ + (bytes - 1) * WHEEL_SIZE) < WHEEL_RESIDUES[bit]) {
+      data_.back() &= static_cast<uint8_t>(~(1u << bit));
+    }
+  }
+  if (base_ == 0) {
+    data_.front() &= UINT8_C(0xFE);
+  }
+  const uint64_t window = sieve_window();
+  uint64_t first = base_ / WHEEL_SIZE;
+  uint64_t last = hi / WHEEL_SIZE;
+  uint64_t root = integer_sqrt(hi);
+  if (root >= window) {
+    resize_buckets(static_cast<size_t>((last - first + root) / window + 2));
+  }
+  if (active_ < head) {
+    add_primes(primes_begin + active_, primes_end);
+  }
+  if (active_ >= head) {
+    add_primes(more_begin + (active_ - head), more_end);
+  }
+  uint64_t stop = hi % WHEEL_SIZE == WHEEL_SIZE - 1 ? UINT64_MAX : last;
+  while (first <= last) {
+    uint64_t end = (first / window + 1) * window - 1;
+    if (end > last) {
+      end = last;
+    }
+    cross_window(first, end, stop);
+    first = end + 1;
+  }
+}
+
+void WheelSieve::reset() noexcept {
+  small_.clear();
+  buckets_.clear();
+  active_ = 0;
+  last_prime_ = 0;
+}
+
+void WheelSieve::add_primes(const uint32_t *primes_begin,
+                            const uint32_t *primes_end) {
+  const uint64_t window = sieve_window();
+  for (const uint32_t *it = primes_begin; it != primes_end; ++it) {
+    uint64_t p = *it;
+    if (p >= 7 && p * p > high_) {
+      break;
+    }
+    ++active_;
+    last_prime_ = *it;
+    if (p <= PRESIEVE_PRIMES[4]) {
+      continue;
+    }
+    uint64_t first = low_ / p + (low_ % p != 0);
+    if (first < p) {
+      first = p;
+    }
+    uint64_t first_mod = first % WHEEL_SIZE;
+    for (uint8_t residue : WHEEL_RESIDUES) {
+      uint64_t q = first + (residue + WHEEL_SIZE - first_mod) % WHEEL_SIZE;
+      Multiple multiple{p * (q / WHEEL_SIZE) + p * residue / WHEEL_SIZE, *it,
+                        WHEEL_INDEX[p % WHEEL_SIZE * residue % WHEEL_SIZE]};
+      if (p < window) {
+        small_.push_back(multiple);
+      } else {
+        buckets_[static_cast<size_t>(multiple.next / window) &
+                 (buckets_.size() - 1)]
+            .push_back(multiple);
+      }
+    }
+  }
+}
+
+void WheelSieve::resize_buckets(size_t count) {
+  if (buckets_.size() >= count) {
+    return;
+  }
+  size_t size = 1;
+  while (size < count) {
+    size *= 2;
+  }
+  const uint64_t window = sieve_window();
+  std::vector<std::vector<Multiple>> old(size);
+  old.swap(buckets_);
+  for (std::vector<Multiple> const &bucket : old) {
+    for (Multiple const &multiple : bucket) {
+      buckets_[static_cast<size_t>(multiple.next / window) & (size - 1)]
+          .push_back(multiple);
+    }
+  }
+}
+
+void WheelSieve::cross_window(uint64_t first, uint64_t last, uint64_t stop) {
+  const uint64_t offset = base_ / WHEEL_SIZE;
+  uint8_t *data = data_.data();
+  for (Multiple &multiple : small_) {
+    uint64_t next = multiple.next;
+    if (next > last) {
+      continue;
+    }
+    const uint64_t prime = multiple.prime;
+    const uint8_t mask = static_cast<uint8_t>(~(1u << multiple.bit));
+    do {
+      data[next - offset] &= mask;
+      next += prime;
+    } while (next <= last);
+    multiple.next = next - prime == stop ? stop : next;
+  }
+  if (buckets_.empty()) {
+    return;
+  }
+  const uint64_t window = sieve_window();
+  const size_t mask = buckets_.size() - 1;
+  spare_.swap(buckets_[static_cast<size_t>(first / window) & mask]);
+  for (Multiple multiple : spare_) {
+    if (multiple.next <= last) {
+      data[multiple.next - offset] &=
+          static_cast<uint8_t>(~(1u << multiple.bit));
+      if (multiple.next != stop) {
+        multiple.next += multiple.prime;
+      }
+    }
+    buckets_[static_cast<size_t>(multiple.next / window) & mask].push_back(
+        multiple);
+  }
+  spare_.clear();
+}
+
+uint64_t WheelSieve::count() const noexcept {
+  if (low_ > high_) {
+    return 0;
+  }
+  uint64_t result = 0;
+  for (uint64_t small : {UINT64_C(2), UINT64_C(3), UINT64_C(5)}) {
+    result += low_ <= small && small <= high_;
+  }
+  return result + sieve_kernels().count(data_.data(), data_.size());
+}
+
+const std::vector<uint8_t> &WheelSieve::bitmap() const noexcept {
+  return data_;
+}
+
+uint64_t WheelSieve::low() const noexcept { return low_; }
+
+uint64_t WheelSieve::high() const noexcept { return high_; }
+
+size_t sieve_window() noexcept {
+  static const size_t window = cache_size(1);
+  return window;
+}
+
+uint64_t segment_size() noexcept {
+  static const uint64_t size =
+      static_cast<uint64_t>(std::max(cache_size(2) / 2, sieve_window())) *
+      WHEEL_SIZE;
+  return size;
+}
+
+uint32_t integer_sqrt(uint64_t value) noexcept {
+  uint64_t root = static_cast<uint64_t>(std::sqrt(static_cast<double>(value)));
+  if (root > UINT32_MAX) {
+    root = UINT32_MAX;
+  }
+  while (root * root > value) {
+    --root;
+  }
+  while (root < UINT32_MAX && (root + 1) * (root + 1) <= value) {
+    ++root;
+  }
+  return static_cast<uint32_t>(root);
+}
+
+std::vector<uint32_t> primes_up_to(uint32_t limit) {
+  std::vector<uint32_t> primes(
+      SMALL_PRIMES.begin(),
+      std::upper_bound(SMALL_PRIMES.begin(), SMALL_PRIMES.end(), limit));
+  WheelSieve sieve;
+  const uint64_t size = segment_size();
+  for (uint64_t lo = SMALL_PRIMES_LIMIT; lo <= limit; lo += size) {
+    uint64_t hi = lo + size - 1 < limit ? lo + size - 1 : limit;
+    sieve.sieve(lo, hi, SMALL_PRIMES.begin(), SMALL_PRIMES.end());
+    sieve.for_each_prime([&primes](uint64_t prime) {
+      primes.push_back(static_cast<uint32_t>(prime));
+    });
+  }
+  return primes;
+}
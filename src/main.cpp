@@ -1,4 +1,10 @@
+#include "../lib/include/prime_filters.h"
 #include "../lib/include/primes.h"
+#include "../lib/include/primes_bitmap.h"
+#include "../lib/include/primes_stream.h"
+#include "../lib/include/primes_writer.h"
+#include "../lib/include/sieve_kernels.h"
+#include "../lib/include/wheel_sieve.h"
 #include <algorithm>
 #include <chrono>
 #include <cstdio>
@@ -7,7 +13,48 @@
 #include <iostream>
 #include <utility>
 
-enum class primes_types : uint32_t { ALL_PRIMES, SUPER_PRIME, MERSENNE };
+#include <sys/resource.h>
+
+enum class primes_types : uint32_t {
+  ALL_PRIMES,
+  SUPER_PRIME,
+  MERSENNE,
+  TWIN,
+  SOPHIE_GERMAIN
+};
+
+const char *type_name(primes_types type) {
+  switch (type) {
+  case primes_types::ALL_PRIMES:
+    return "All primes";
+  case primes_types::SUPER_PRIME:
+    return "Super simple";
+  case primes_types::MERSENNE:
+    return "Mersenne";
+  case primes_types::TWIN:
+    return "Twin";
+  case primes_types::SOPHIE_GERMAIN:
+    return "Sophie Germain";
+  }
+  return "";
+}
+
+template <typename F>
+void for_each_subset(primes_types type, PrimesBitmap const &bitmap, F f) {
+  switch (type) {
+  case primes_types::SUPER_PRIME:
+    for_each_super_prime(bitmap, f);
+    break;
+  case primes_types::TWIN:
+    for_each_twin_prime(bitmap, f);
+    break;
+  case primes_types::SOPHIE_GERMAIN:
+    for_each_sophie_germain(bitmap, f);
+    break;
+  default:
+    break;
+  }
+}
 
 struct quest {
   uint32_t by_max{100};
@@ -15,6 +62,7 @@ struct quest {
   primes_types primes_type{primes_types::ALL_PRIMES};
   const char *output_file{nullptr};
   const char *stat_file{nullptr};
+  const char *cache_file{nullptr};
 };
 
 bool parse_args(quest &spec, int argc, char *argv[]) {
@@ -24,6 +72,7 @@ bool parse_args(quest &spec, int argc, char *argv[]) {
   //  -f --file       // file_name
   //  -o --option     // diff types of primes
   //  -s --stat       // file_name
+  //  -c --cache      // file_name
   for (int i = 1; i < argc; ++i) {
     if (std::strcmp(argv[i], "-h") == 0 ||
         std::strcmp(argv[i], "--help") == 0) {
@@ -33,10 +82,13 @@ bool parse_args(quest &spec, int argc, char *argv[]) {
              "-m --max_number [max_number]                to set up max prime\n"
              "-f --file       [file_name]                 to redirect primes "
              "output to \"file_name\"\n"
-             "-o --option     [all|super_simple|mersenne] to set up special "
+             "-o --option     [all|super_prime|mersenne|  to set up special "
              "prime's type\n"
-             "-s --stat       [file_name]                 to print additional "
-             "info to \"file_name\"\n";
+             "                 twin|sophie_germain]\n"
+             "-s --stat       [file_name]                 to append run stats "
+             "as JSON to \"file_name\"\n"
+             "-c --cache      [file_name]                 to load and save "
+             "found primes in \"file_name\"\n";
       return false;
     }
     if (std::strcmp(argv[i], "-n") == 0 ||
@@ -81,6 +133,16 @@ bool parse_args(quest &spec, int argc, char *argv[]) {
       }
       continue;
     }
+    if (std::strcmp(argv[i], "-c") == 0 ||
+        std::strcmp(argv[i], "--cache") == 0) {
+      if (i + 1 < argc) {
+        spec.cache_file = argv[++i];
+      } else {
+        std::cout << "Wrong cache param" << std::endl;
+        return false;
+      }
+      continue;
+    }
     if (std::strcmp(argv[i], "-o") == 0 ||
         std::strcmp(argv[i], "--option") == 0) {
       if (i + 1 < argc) {
@@ -97,6 +159,14 @@ bool parse_args(quest &spec, int argc, char *argv[]) {
           spec.primes_type = primes_types::MERSENNE;
           continue;
         }
+        if (std::strcmp(argv[i], "twin") == 0) {
+          spec.primes_type = primes_types::TWIN;
+          continue;
+        }
+        if (std::strcmp(argv[i], "sophie_germain") == 0) {
+          spec.primes_type = primes_types::SOPHIE_GERMAIN;
+          continue;
+        }
       }
       std::cout << "Wrong option param" << std::endl;
       return false;
@@ -107,15 +177,6 @@ bool parse_args(quest &spec, int argc, char *argv[]) {
   return true;
 }
 
-void write(FILE *output_file, uint32_t prime) {
-  if (output_file) {
-    std::fprintf(output_file, "%u\n", prime);
-  } else {
-    std::cout << prime << ' ';
-    std::fflush(stdout);
-  }
-}
-
 int main(int argc, char *argv[]) {
 
   quest spec{};
@@ -146,98 +207,119 @@ int main(int argc, char *argv[]) {
                "_________________________________\nSpecialization:\n%s -- "
                "%u\noption -- %s\n%s\n_________________________________\n",
                spec.by_amount ? "by amount" : "by max number",
-               spec.by_amount + spec.by_max,
-               (spec.primes_type == primes_types::ALL_PRIMES)
-                   ? "All primes"
-                   : ((spec.primes_type == primes_types::SUPER_PRIME)
-                          ? "Super simple"
-                          : "Mersenne"),
+               spec.by_amount + spec.by_max, type_name(spec.primes_type),
                output_file ? "to file" : "to stdout");
-  if (stat_file) {
-    std::fprintf(stat_file,
-                 "_________________________________\nSpecialization:\n%s -- "
-                 "%u\noption -- %s\n%s\n_________________________________\n",
-                 spec.by_amount ? "by amount" : "by max number",
-                 spec.by_amount + spec.by_max,
-                 (spec.primes_type == primes_types::ALL_PRIMES)
-                     ? "All primes"
-                     : ((spec.primes_type == primes_types::SUPER_PRIME)
-                            ? "Super simple"
-                            : "Mersenne"),
-                 output_file ? "to file" : "to stdout");
-  }
 
-  std::vector<uint32_t> primes_only;
-  auto checker = [&spec](Primes &obj, uint32_t pos) -> bool {
-    if (!obj[pos]) {
-      return false;
-    }
-    switch (spec.primes_type) {
-    case primes_types::ALL_PRIMES: {
-      return true;
-    }
-    case primes_types::SUPER_PRIME: {
-      auto it_pos = std::lower_bound(
-          obj.begin(), obj.begin() + static_cast<int32_t>(pos), pos + 1);
-      return it_pos != obj.begin() + static_cast<int32_t>(pos) &&
-             *it_pos == pos + 1;
-    }
-    case primes_types::MERSENNE: {
-      return ((obj[pos] + UINT32_C(1)) & obj[pos]) == 0;
-    }
-    }
-    return false;
-  };
+  PrimesWriter writer(fileno(output_file ? output_file : stdout),
+                      output_file ? '\n' : ' ');
   std::cout << "Starting..." << std::endl;
   auto start_time = std::chrono::high_resolution_clock::now();
-  if (spec.by_amount) {
-    Primes obj;
-    for (uint32_t i = 0; obj[i] > 0 && primes_only.size() < spec.by_amount;
-         ++i) {
-      if (checker(obj, i)) {
-        primes_only.push_back(obj[i]);
+  if (spec.cache_file) {
+    MappedPrimes::load(spec.cache_file);
+  }
+  size_t extra_memory = 0;
+  if (spec.primes_type == primes_types::MERSENNE) {
+    for_each_mersenne(spec.by_amount ? UINT32_MAX : spec.by_max,
+                      [&spec, &writer](uint64_t prime) {
+                        if (!spec.by_amount ||
+                            writer.count() < spec.by_amount) {
+                          writer.write(prime);
+                        }
+                      });
+  } else if (spec.primes_type != primes_types::ALL_PRIMES) {
+    uint64_t max_value = spec.by_amount
+                             ? std::min<uint64_t>(UINT64_C(16) * spec.by_amount,
+                                                  UINT32_MAX)
+                             : spec.by_max;
+    for (;;) {
+      // p is a Sophie Germain prime only if 2p + 1 is in the bitmap too.
+      PrimesBitmap bitmap(spec.primes_type == primes_types::SOPHIE_GERMAIN
+                              ? 2 * max_value + 1
+                              : max_value);
+      uint64_t found = 0;
+      if (spec.by_amount && max_value < UINT32_MAX) {
+        for_each_subset(spec.primes_type, bitmap,
+                        [&found, max_value](uint64_t prime) {
+                          found += prime <= max_value;
+                        });
+        if (found < spec.by_amount) {
+          max_value = std::min<uint64_t>(4 * max_value, UINT32_MAX);
+          continue;
+        }
+      }
+      for_each_subset(spec.primes_type, bitmap,
+                      [&spec, &writer, max_value](uint64_t prime) {
+                        if (prime <= max_value &&
+                            (!spec.by_amount ||
+                             writer.count() < spec.by_amount)) {
+                          writer.write(prime);
+                        }
+                      });
+      extra_memory = bitmap.memory();
+      break;
+    }
+  } else if (spec.by_amount && !spec.cache_file) {
+    PrimesStream stream;
+    for (uint32_t prime : stream) {
+      if (writer.count() >= spec.by_amount) {
+        break;
       }
+      writer.write(prime);
     }
+    extra_memory = stream.memory();
+  } else if (spec.by_amount) {
+    MappedPrimes obj;
+    for (uint32_t i = 0; obj[i] > 0 && writer.count() < spec.by_amount; ++i) {
+      writer.write(obj[i]);
+    }
+  } else if (!spec.cache_file) {
+    for_each_segment(0, spec.by_max, [&writer](WheelSieve const &segment) {
+      segment.for_each_prime(
+          [&writer](uint64_t prime) { writer.write(prime); });
+    });
   } else {
-    Primes obj(spec.by_max);
+    MappedPrimes obj(spec.by_max);
     for (uint32_t i = 0; i < obj.size(); ++i) {
-      if (checker(obj, i)) {
-        primes_only.push_back(obj[i]);
-      }
+      writer.write(obj[i]);
     }
   }
+  writer.flush();
   auto end_time = std::chrono::high_resolution_clock::now();
   auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(end_time -
                                                                     start_time)
                   .count();
-  std::cout << "Finished" << std::endl;
-  if (output_file) {
-    std::for_each(primes_only.begin(), primes_only.end(),
-                  [output_file](uint32_t prime) {
-                    std::fprintf(output_file, "%u\n", prime);
-                  });
-  } else {
-    std::for_each(primes_only.begin(), primes_only.end(),
-                  [](uint32_t prime) { std::cout << prime << ' '; });
+  if (!output_file) {
     std::cout << std::endl;
   }
+  std::cout << "Finished" << std::endl;
+  if (spec.cache_file && !MappedPrimes::save(spec.cache_file)) {
+    std::cout << "Can't save cache file" << std::endl;
+  }
 
-  Primes mem_check;
-  uint32_t mem_used =
-      static_cast<uint32_t>(mem_check.size() + primes_only.size());
+  PrimesCacheStats stats = MappedPrimes::stats();
+  uint64_t memory = stats.memory + WRITER_BUFFER + extra_memory;
+  struct rusage usage {};
+  getrusage(RUSAGE_SELF, &usage);
+  uint64_t peak = static_cast<uint64_t>(usage.ru_maxrss) * 1024;
   std::fprintf(stdout,
-               "Written %u primes in %ld ms\nMemory used (approximately) "
-               "%u%s\n_________________________________\n",
-               static_cast<uint32_t>(primes_only.size()), diff,
-               (mem_used / 262144 ? mem_used / 262144 : mem_used / 256),
-               (mem_used / 262144 ? "MB" : "KB"));
+               "Written %u primes in %ld ms\nMemory used %llu%s, peak "
+               "resident %lluMB\n_________________________________\n",
+               static_cast<uint32_t>(writer.count()), diff,
+               static_cast<unsigned long long>(memory >> 20 ? memory >> 20
+                                                            : memory >> 10),
+               memory >> 20 ? "MB" : "KB",
+               static_cast<unsigned long long>(peak >> 20));
   if (stat_file) {
     std::fprintf(stat_file,
-                 "Written %u primes in %ld ms\nMemory used (approximately) "
-                 "%u%s\n_________________________________\n",
-                 static_cast<uint32_t>(primes_only.size()), diff,
-                 (mem_used / 262144 ? mem_used / 262144 : mem_used / 256),
-                 (mem_used / 262144 ? "MB" : "KB"));
+                 "{\"mode\": \"%s\", \"limit\": %u, \"option\": \"%s\", "
+                 "\"written\": %llu, \"ms\": %ld, \"memory\": %llu, "
+                 "\"peak_resident\": %llu, \"isa\": \"%s\", \"cache\": %s}\n",
+                 spec.by_amount ? "by amount" : "by max number",
+                 spec.by_amount + spec.by_max, type_name(spec.primes_type),
+                 static_cast<unsigned long long>(writer.count()), diff,
+                 static_cast<unsigned long long>(memory),
+                 static_cast<unsigned long long>(peak), sieve_kernels().isa,
+                 to_json(stats).c_str());
     std::fclose(stat_file);
   }
   if (output_file) {